@@ -0,0 +1,45 @@
+#include <libhoard/any_cache_adapter.h>
+#include <libhoard/cache.h>
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+
+// Compares lookups through a cache with lookups through an any_cache, that refers to the same cache.
+// The difference is the cost of the virtual function call.
+//
+// Each round looks up every element once.
+
+constexpr int element_count = 1024;
+constexpr std::size_t rounds = 2000;
+
+template<typename Cache>
+auto run(const char* name, const Cache& c) -> double {
+  long long sum = 0;
+
+  const auto b = std::chrono::steady_clock::now();
+  for (std::size_t r = 0; r < rounds; ++r) {
+    for (int i = 0; i < element_count; ++i)
+      sum += c.get_if_exists(i).value_or(0);
+  }
+  const std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - b;
+
+  if (sum != static_cast<long long>(rounds) * element_count * (element_count - 1) / 2)
+    std::cerr << "wrong sum: " << sum << std::endl;
+
+  const double ns_per_op = duration.count() / (element_count * rounds);
+  std::cout << std::setw(24) << std::left << name << std::right
+      << std::fixed << std::setprecision(3) << std::setw(8) << ns_per_op << " ns per lookup" << std::endl;
+  return ns_per_op;
+}
+
+int main() {
+  libhoard::cache<int, int> c;
+  for (int i = 0; i < element_count; ++i) c.emplace(i, i);
+  const libhoard::any_cache<int, int> any = libhoard::make_any_cache(c);
+
+  const double direct = run("cache:", c);
+  const double erased = run("any_cache:", any);
+  std::cout << "overhead: " << std::fixed << std::setprecision(3) << erased - direct << " ns per lookup" << std::endl;
+}
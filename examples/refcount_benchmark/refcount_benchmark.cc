@@ -0,0 +1,50 @@
+#include <libhoard/detail/refcount.h>
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// Compares the cost of the atomic reference counter, used by thread-safe caches,
+// with the plain reference counter, used by caches with the thread_unsafe_policy.
+//
+// Each round copies a pointer to every element into a vector, and then clears the vector.
+// So each element sees one increment and one decrement per round.
+
+constexpr std::size_t element_count = 1024;
+constexpr std::size_t rounds = 20000;
+
+template<typename Refcount>
+struct element : Refcount {};
+
+template<typename Refcount>
+auto run(const char* name) -> double {
+  using pointer = libhoard::detail::refcount_ptr<element<Refcount>, std::allocator<element<Refcount>>>;
+
+  std::vector<pointer> elements;
+  for (std::size_t i = 0; i < element_count; ++i)
+    elements.push_back(libhoard::detail::allocate_refcount<element<Refcount>>(std::allocator<element<Refcount>>()));
+
+  std::vector<pointer> copies;
+  copies.reserve(element_count);
+
+  const auto b = std::chrono::steady_clock::now();
+  for (std::size_t r = 0; r < rounds; ++r) {
+    copies.assign(elements.begin(), elements.end());
+    copies.clear();
+  }
+  const std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - b;
+
+  const double ns_per_op = duration.count() / (element_count * rounds);
+  std::cout << std::setw(24) << std::left << name << std::right
+      << std::fixed << std::setprecision(3) << std::setw(8) << ns_per_op << " ns per copy+release" << std::endl;
+  return ns_per_op;
+}
+
+int main() {
+  const double atomic = run<libhoard::detail::refcount>("atomic refcount:");
+  const double plain = run<libhoard::detail::unsynchronized_refcount>("unsynchronized refcount:");
+  std::cout << "speedup: " << std::fixed << std::setprecision(2) << atomic / plain << "x" << std::endl;
+}
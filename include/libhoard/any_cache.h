@@ -0,0 +1,76 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+
+namespace libhoard {
+
+
+/**
+ * \brief Interface of the caches that an any_cache refers to.
+ * \details
+ * Implemented by any_cache_adapter.
+ * \ingroup libhoard_api
+ */
+template<typename KeyType, typename T>
+class any_cache_interface {
+  protected:
+  any_cache_interface() noexcept = default;
+  any_cache_interface(const any_cache_interface&) noexcept = default;
+  auto operator=(const any_cache_interface&) noexcept -> any_cache_interface& = default;
+
+  public:
+  virtual ~any_cache_interface() noexcept = default;
+
+  virtual auto get_if_exists(const KeyType& key) const -> std::optional<T> = 0;
+  virtual auto emplace(KeyType key, T mapped) -> void = 0;
+  virtual auto get_or_emplace(KeyType key, T mapped) -> T = 0;
+  virtual auto erase(const KeyType& key) noexcept -> void = 0;
+  virtual auto clear() noexcept -> void = 0;
+};
+
+
+/**
+ * \brief Cache with a type that doesn't depend on its policies.
+ * \details
+ * An any_cache refers to a libhoard::cache, and forwards each call to it, using a virtual function call.
+ * Copies of an any_cache refer to the same cache.
+ *
+ * The point of this type is that code which uses the cache, only needs this header.
+ * So those translation units don't instantiate the cache and its policies.
+ * The cache is created by make_any_cache(), in a translation unit that includes any_cache_adapter.h.
+ *
+ * Only lookups by key type are supported, and there is no resolver based get.
+ * \tparam KeyType The key type of the cache.
+ * \tparam T The mapped type of the cache.
+ * \ingroup libhoard_api
+ */
+template<typename KeyType, typename T>
+class any_cache {
+  public:
+  using key_type = KeyType;
+  using mapped_type = T;
+  using interface_type = any_cache_interface<KeyType, T>;
+
+  ///\brief Create an any_cache that refers to the given implementation.
+  explicit any_cache(std::shared_ptr<interface_type> impl) noexcept;
+
+  ///\brief Look up a value, without invoking a resolver.
+  auto get_if_exists(const KeyType& key) const -> std::optional<T>;
+  ///\brief Add a value to the cache, replacing any existing value for the key.
+  auto emplace(KeyType key, T mapped) -> void;
+  ///\brief Look up a value, adding \p mapped if the key isn't present.
+  auto get_or_emplace(KeyType key, T mapped) -> T;
+  ///\brief Remove a value from the cache.
+  auto erase(const KeyType& key) noexcept -> void;
+  ///\brief Remove all values from the cache.
+  auto clear() noexcept -> void;
+
+  private:
+  std::shared_ptr<interface_type> impl_;
+};
+
+
+} /* namespace libhoard */
+
+#include "any_cache.ii"
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "any_cache.h"
+#include "cache.h"
+
+namespace libhoard {
+
+
+/**
+ * \brief Implements any_cache_interface, by forwarding to a cache.
+ * \details
+ * This is where the cache gets instantiated.
+ * To instantiate it in only one translation unit, declare it in a header:
+ * \code
+ * extern template class libhoard::any_cache_adapter<int, std::string, libhoard::max_size_policy>;
+ * \endcode
+ * and define it in a single source file:
+ * \code
+ * template class libhoard::any_cache_adapter<int, std::string, libhoard::max_size_policy>;
+ * \endcode
+ * \tparam KeyType The key type of the cache.
+ * \tparam T The mapped type of the cache.
+ * \tparam Policies The policies of the cache.
+ * \ingroup libhoard_api
+ */
+template<typename KeyType, typename T, typename... Policies>
+class any_cache_adapter final
+: public any_cache_interface<KeyType, T>
+{
+  public:
+  using cache_type = cache<KeyType, T, Policies...>;
+
+  ///\brief Create an adapter that refers to the same cache as \p c.
+  explicit any_cache_adapter(cache_type c) noexcept;
+
+  auto get_if_exists(const KeyType& key) const -> std::optional<T> override;
+  auto emplace(KeyType key, T mapped) -> void override;
+  auto get_or_emplace(KeyType key, T mapped) -> T override;
+  auto erase(const KeyType& key) noexcept -> void override;
+  auto clear() noexcept -> void override;
+
+  private:
+  cache_type cache_;
+};
+
+
+/**
+ * \brief Create an any_cache that refers to a cache.
+ * \details
+ * The any_cache and \p c share the same elements.
+ * \relates any_cache
+ */
+template<typename KeyType, typename T, typename... Policies>
+auto make_any_cache(cache<KeyType, T, Policies...> c) -> any_cache<KeyType, T>;
+
+
+} /* namespace libhoard */
+
+#include "any_cache_adapter.ii"
@@ -1,11 +1,15 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <tuple>
 
 #include <asio/system_executor.hpp>
 #include <asio/wait_traits.hpp>
 #include <asio/basic_waitable_timer.hpp>
 
+#include "../refresh_pacing.h"
+#include "../detail/indexed_heap.h"
 #include "../detail/meta.h"
 #include "../detail/refresh_impl_policy.h"
 
@@ -19,11 +23,12 @@ class asio_refresh_policy {
   class value_base;
   template<typename HashTable, typename ValueType, typename Allocator> class table_base;
 
-  explicit asio_refresh_policy(Executor executor, typename Clock::duration delay, typename Clock::duration idle_timer = Clock::duration::zero());
+  explicit asio_refresh_policy(Executor executor, typename Clock::duration delay, typename Clock::duration idle_timer = Clock::duration::zero(), refresh_pacing<Clock> pacing = refresh_pacing<Clock>());
 
   private:
   typename Clock::duration delay, idle_timer;
   Executor executor;
+  refresh_pacing<Clock> pacing;
 };
 
 template<typename Clock, typename Executor, typename WaitTraits>
@@ -39,7 +44,7 @@ class asio_refresh_policy<Clock, Executor, WaitTraits>::value_base {
 
   private:
   asio::basic_waitable_timer<Clock, WaitTraits, Executor> refresh;
-  typename Clock::time_point cancel_tp = Clock::time_point::max();
+  std::atomic<typename Clock::time_point> cancel_tp{ Clock::time_point::max() }; // Atomic: the thread_local_front_policy reads it without the lock.
 };
 
 template<typename Clock, typename Executor, typename WaitTraits>
@@ -56,8 +61,13 @@ class asio_refresh_policy<Clock, Executor, WaitTraits>::table_base {
   auto on_unlink_(value_base* vptr) noexcept -> void;
 
   private:
+  ///\brief Start waiting for the refresh timer of \p vptr.
+  ///\param slot_reserved If true, the rate limit has already been applied to this refresh.
+  auto arm_timer_(ValueType* vptr, bool slot_reserved) -> void;
+
   typename Clock::duration delay, idle_timer;
   Executor executor;
+  refresh_pacing<Clock> pacing;
 };
 
 
@@ -89,7 +99,7 @@ class asio_refresh_fn_policy<Clock, RefreshFn, Executor, WaitTraits>::value_base
 
   private:
   asio::basic_waitable_timer<Clock, WaitTraits, Executor> refresh;
-  typename Clock::time_point cancel_tp = Clock::time_point::max();
+  std::atomic<typename Clock::time_point> cancel_tp{ Clock::time_point::max() }; // Atomic: the thread_local_front_policy reads it without the lock.
 };
 
 template<typename Clock, typename RefreshFn, typename Executor, typename WaitTraits>
@@ -117,6 +127,96 @@ class asio_refresh_fn_policy<Clock, RefreshFn, Executor, WaitTraits>::table_base
 };
 
 
+/**
+ * \brief Policy that periodically refreshes values in the cache, using a single asio timer.
+ * \details
+ * Behaves like the asio_refresh_policy, but instead of a timer per value,
+ * the cache has one timer, armed for the earliest refresh.
+ * Pending refreshes are kept in a heap.
+ * When the timer fires, all values that are due are refreshed in one go.
+ *
+ * This keeps the values small, and keeps the number of outstanding timers
+ * on the executor at one, regardless of the number of values in the cache.
+ * \tparam Clock The clock used to schedule refreshes.
+ * \tparam Executor The executor on which the timer runs.
+ * \tparam WaitTraits Wait traits for the timer.
+ */
+template<typename Clock, typename Executor = asio::system_executor, typename WaitTraits = asio::wait_traits<Clock>>
+class asio_batch_refresh_policy {
+  private:
+  struct tag;
+  struct refresh_order;
+
+  public:
+  using dependencies = detail::type_list<detail::refresh_impl_policy>;
+  class value_base;
+  template<typename HashTable, typename ValueType, typename Allocator> class table_base;
+
+  explicit asio_batch_refresh_policy(Executor executor, typename Clock::duration delay, typename Clock::duration idle_timer = Clock::duration::zero(), refresh_pacing<Clock> pacing = refresh_pacing<Clock>());
+
+  private:
+  typename Clock::duration delay, idle_timer;
+  Executor executor;
+  refresh_pacing<Clock> pacing;
+};
+
+template<typename Clock, typename Executor, typename WaitTraits>
+class asio_batch_refresh_policy<Clock, Executor, WaitTraits>::value_base
+: public detail::indexed_heap_link<tag>
+{
+  template<typename HashTable, typename ValueType, typename Allocator> friend class asio_batch_refresh_policy::table_base;
+  friend asio_batch_refresh_policy::refresh_order;
+
+  public:
+  template<typename HashTable>
+  explicit value_base(const HashTable& table);
+
+  auto expired() const noexcept -> bool;
+  auto on_refresh(const value_base* old_value) noexcept -> void;
+
+  private:
+  typename Clock::time_point refresh_tp;
+  std::atomic<typename Clock::time_point> cancel_tp{ Clock::time_point::max() }; // Atomic: the thread_local_front_policy reads it without the lock.
+  bool slot_reserved = false; // Set if the rate limit has already been applied to this refresh.
+};
+
+///\brief Orders values by their refresh time.
+template<typename Clock, typename Executor, typename WaitTraits>
+struct asio_batch_refresh_policy<Clock, Executor, WaitTraits>::refresh_order {
+  auto operator()(const value_base& x, const value_base& y) const noexcept -> bool;
+};
+
+template<typename Clock, typename Executor, typename WaitTraits>
+template<typename HashTable, typename ValueType, typename Allocator>
+class asio_batch_refresh_policy<Clock, Executor, WaitTraits>::table_base {
+  public:
+  table_base(const asio_batch_refresh_policy& policy, const Allocator& allocator);
+  table_base(asio_batch_refresh_policy&& policy, const Allocator& allocator);
+
+  auto on_reserve_(ValueType* vptr) -> void;
+  auto on_create_(ValueType* vptr) noexcept -> void;
+  auto on_assign_(ValueType* vptr, bool value, bool assigned_via_callback) noexcept -> void;
+  auto on_hit_(ValueType* vptr) noexcept -> void;
+  auto on_unlink_(ValueType* vptr) noexcept -> void;
+
+  private:
+  ///\brief Schedule \p vptr for refresh at \p tp.
+  auto schedule_(ValueType* vptr, typename Clock::time_point tp) noexcept -> void;
+  ///\brief Make the timer fire at \p tp.
+  ///\details If the timer can't be armed, it stays idle until the next call.
+  auto arm_timer_(typename Clock::time_point tp) noexcept -> void;
+  ///\brief Refresh all values that are due, and re-arm the timer.
+  auto on_timer_() -> void;
+
+  typename Clock::duration delay, idle_timer;
+  refresh_pacing<Clock> pacing;
+  detail::indexed_heap<ValueType, tag, refresh_order, typename std::allocator_traits<Allocator>::template rebind_alloc<ValueType*>> delay_queue;
+  std::size_t linked = 0; // Number of linked elements, the delay_queue has room for all of them.
+  asio::basic_waitable_timer<Clock, WaitTraits, Executor> timer;
+  typename Clock::time_point timer_tp = Clock::time_point::max(); // Time at which the timer fires. Max if the timer is idle.
+};
+
+
 } /* namespace libhoard */
 
 #include "refresh_policy.ii"
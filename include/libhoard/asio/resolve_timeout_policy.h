@@ -0,0 +1,81 @@
+#pragma once
+
+#include <asio/system_executor.hpp>
+#include <asio/wait_traits.hpp>
+#include <asio/basic_waitable_timer.hpp>
+
+#include "../resolve_timeout_policy.h"
+#include "../shared_from_this_policy.h"
+#include "../detail/linked_list.h"
+#include "../detail/meta.h"
+
+namespace libhoard {
+
+
+/**
+ * \brief Policy that fails resolves that don't complete in time, using an asio timer.
+ * \details
+ * Behaves like the resolve_timeout_policy, but instead of a worker thread,
+ * a single timer on the executor tracks the earliest deadline.
+ * \tparam Clock The clock used to measure the timeout.
+ * \tparam Executor The executor on which the timer runs.
+ * \tparam WaitTraits Wait traits for the timer.
+ * \ingroup libhoard_api
+ */
+template<typename Clock, typename Executor = asio::system_executor, typename WaitTraits = asio::wait_traits<Clock>>
+class asio_resolve_timeout_policy {
+  private:
+  struct tag;
+
+  public:
+  using dependencies = detail::type_list<shared_from_this_policy>;
+  class value_base;
+  template<typename HashTable, typename ValueType, typename Allocator> class table_base;
+
+  asio_resolve_timeout_policy(Executor executor, typename Clock::duration timeout);
+
+  private:
+  typename Clock::duration timeout;
+  Executor executor;
+};
+
+template<typename Clock, typename Executor, typename WaitTraits>
+class asio_resolve_timeout_policy<Clock, Executor, WaitTraits>::value_base
+: public detail::linked_list_link<tag>
+{
+  template<typename HashTable, typename ValueType, typename Allocator> friend class asio_resolve_timeout_policy::table_base;
+
+  public:
+  template<typename HashTable>
+  explicit value_base(const HashTable& table);
+
+  private:
+  typename Clock::time_point deadline;
+};
+
+template<typename Clock, typename Executor, typename WaitTraits>
+template<typename HashTable, typename ValueType, typename Allocator>
+class asio_resolve_timeout_policy<Clock, Executor, WaitTraits>::table_base {
+  public:
+  table_base(const asio_resolve_timeout_policy& policy, const Allocator& allocator);
+
+  auto on_create_(ValueType* vptr) noexcept -> void;
+  auto on_assign_(ValueType* vptr, bool value, bool assigned_via_callback) noexcept -> void;
+  auto on_unlink_(ValueType* vptr) noexcept -> void;
+
+  private:
+  ///\brief Make the timer fire at \p tp.
+  auto arm_timer_(typename Clock::time_point tp) -> void;
+  ///\brief Fail all values that are past their deadline, and re-arm the timer.
+  auto on_timer_() -> void;
+
+  typename Clock::duration timeout;
+  detail::linked_list<ValueType, tag> deadline_queue; // All values use the same timeout, so the queue is ordered by deadline.
+  asio::basic_waitable_timer<Clock, WaitTraits, Executor> timer;
+  bool timer_armed = false;
+};
+
+
+} /* namespace libhoard */
+
+#include "resolve_timeout_policy.ii"
@@ -77,11 +77,14 @@ class asio_resolver_policy<Functor, Executor>::table_base {
     auto new_value = self->allocate_value_type(std::piecewise_construct, std::forward_as_tuple(keys...));
 
     self->link(hash, new_value);
-    executor.dispatch(
-        [functor=this->functor, cb=std::allocate_shared<callback>(callback_allocator_type(self->get_allocator()), self->shared_from_this(), new_value), keys...]() mutable {
-          std::invoke(std::move(functor), std::move(cb), std::move(keys)...);
-        },
-        self->get_allocator());
+    detail::start_resolve(*self, new_value.get(),
+        [this, cb=std::allocate_shared<callback>(callback_allocator_type(self->get_allocator()), self->shared_from_this(), new_value), keys...]() {
+          executor.dispatch(
+              [functor=this->functor, cb, keys...]() mutable {
+                std::invoke(std::move(functor), std::move(cb), std::move(keys)...);
+              },
+              static_cast<HashTable*>(this)->get_allocator());
+        });
     return new_value;
   }
 
@@ -131,7 +134,7 @@ class cache_base<asio_resolver_policy<Functor, Executor>, Impl, HashTableType> {
         [ work=::asio::executor_work_guard<::asio::associated_executor_t<completion_handler_type, Executor>>(executor),
           completion_handler=std::move(completion_handler),
           alloc1=self->impl_->get_allocator()
-        ](typename HashTableType::mapped_type value, typename HashTableType::error_type err, auto is_immediately_resolved) mutable {
+        ](typename HashTableType::mapped_type value, typename HashTableType::error_type err, [[maybe_unused]] auto is_immediately_resolved) mutable {
           auto alloc = ::asio::get_associated_allocator(completion_handler, std::move(alloc1));
           auto callback = [ completion_handler=std::move(completion_handler),
                             value=std::move(value),
@@ -140,10 +143,9 @@ class cache_base<asio_resolver_policy<Functor, Executor>, Impl, HashTableType> {
             std::invoke(std::move(completion_handler), std::move(value), std::move(err));
           };
 
-          if constexpr(is_immediately_resolved())
-            work.get_executor().post(std::move(callback), std::move(alloc));
-          else
-            work.get_executor().dispatch(std::move(callback), std::move(alloc));
+          // Always post: deferred completions run while the cache is locked,
+          // and dispatch could run the handler inline.
+          work.get_executor().post(std::move(callback), std::move(alloc));
         },
         keys...);
 
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
+#include <iterator>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -15,6 +18,8 @@
 namespace libhoard {
 
 
+template<typename KeyType, typename T, typename... Policies> class sharded_cache;
+
 template<typename KeyType, typename T, typename... Policies>
 class cache
 : public detail::cache_get<cache<KeyType, T, Policies...>, detail::hashtable<KeyType, T, Policies...>>,
@@ -22,11 +27,17 @@ class cache
 {
   template<typename Impl, typename HashTableType> friend class detail::cache_get_impl;
   template<typename Tag, typename Cache, typename HashTable> friend class detail::cache_base;
+  friend class sharded_cache<KeyType, T, Policies...>;
 
   private:
   using hashtable_type = detail::hashtable<KeyType, T, Policies...>;
 
   public:
+  ///\brief Handle to a value in the cache. Dereferences to `const T&`.
+  using handle_type = typename hashtable_type::handle_type;
+  ///\brief Default number of buckets that erase_if() and for_each() visit, before releasing the lock.
+  static constexpr std::size_t default_buckets_per_chunk = 64;
+
   template<typename... Args>
   explicit cache(Args&&... args)
   : impl_(std::make_shared<hashtable_type>(std::forward<Args>(args)...))
@@ -60,6 +71,53 @@ class cache
     impl_->expire(keys...);
   }
 
+  /**
+   * \brief Remove all values for which the predicate holds.
+   * \details
+   * The cache is walked in chunks of \p buckets_per_chunk buckets.
+   * The lock is released between chunks, so other threads don't have to wait for the whole walk.
+   *
+   * Pending and expired elements are skipped.
+   * Each element that is in the cache for the whole walk, is tested exactly once.
+   * Elements that are added during the walk, may or may not be tested.
+   *
+   * The predicate is invoked with the lock held, so it must not use the cache.
+   * \param pred Predicate, invoked as `pred(const key_type&, const T&)`.
+   * \param buckets_per_chunk Number of buckets visited in each chunk.
+   * \return The number of removed elements.
+   */
+  template<typename Pred>
+  auto erase_if(Pred&& pred, std::size_t buckets_per_chunk = default_buckets_per_chunk) -> std::size_t {
+    std::size_t erased = 0;
+    walk_(
+        [&pred, &erased](const typename hashtable_type::key_type& key, const T& mapped) -> bool {
+          if (!std::invoke(pred, key, mapped)) return false;
+          ++erased;
+          return true;
+        },
+        buckets_per_chunk);
+    return erased;
+  }
+
+  /**
+   * \brief Invoke a function for each value in the cache.
+   * \details
+   * The cache is walked in chunks, like erase_if().
+   *
+   * The function is invoked with the lock held, so it must not use the cache.
+   * \param fn Function, invoked as `fn(const key_type&, const T&)`.
+   * \param buckets_per_chunk Number of buckets visited in each chunk.
+   */
+  template<typename Fn>
+  auto for_each(Fn&& fn, std::size_t buckets_per_chunk = default_buckets_per_chunk) -> void {
+    walk_(
+        [&fn](const typename hashtable_type::key_type& key, const T& mapped) -> bool {
+          std::invoke(fn, key, mapped);
+          return false;
+        },
+        buckets_per_chunk);
+  }
+
   template<typename... Keys, typename... MappedArgs>
   auto emplace(std::piecewise_construct_t pc, std::tuple<Keys...> keys, std::tuple<MappedArgs...> mapped) -> void {
     std::lock_guard<hashtable_type> lck{ *impl_ };
@@ -74,6 +132,36 @@ class cache
     impl_->emplace(std::forward<KeyArg>(key), std::forward<MappedArg>(mapped));
   }
 
+  /**
+   * \brief Emplace a sequence of key-value pairs.
+   * \details
+   * Has the same effect as calling emplace() for each pair, but takes the lock only once.
+   * If no policy limits the size of the cache, the cache is grown once, up front.
+   * \param first,last Range of pair-like elements, for example from a `std::map` or a `std::vector<std::pair<KeyType, T>>`.
+   */
+  template<typename Iter>
+  auto emplace_many(Iter first, Iter last) -> void {
+    std::lock_guard<hashtable_type> lck{ *impl_ };
+
+    impl_->emplace_many(std::move(first), std::move(last));
+  }
+
+  /**
+   * \brief Emplace all key-value pairs in a container.
+   * \details
+   * If the container is an rvalue, its elements are moved into the cache.
+   */
+  template<typename Container>
+  auto emplace_many(Container&& c) -> void {
+    using std::begin;
+    using std::end;
+
+    if constexpr(std::is_lvalue_reference_v<Container>)
+      emplace_many(begin(c), end(c));
+    else
+      emplace_many(std::make_move_iterator(begin(c)), std::make_move_iterator(end(c)));
+  }
+
   template<typename... Keys, typename... MappedArgs>
   auto get_or_emplace(std::piecewise_construct_t pc, std::tuple<Keys...> keys, std::tuple<MappedArgs...> mapped) -> T {
     std::lock_guard<hashtable_type> lck{ *impl_ };
@@ -89,6 +177,16 @@ class cache
   }
 
   private:
+  ///\brief Walk the cache in chunks, removing the elements for which \p fn returns true.
+  template<typename Fn>
+  auto walk_(Fn&& fn, std::size_t buckets_per_chunk) -> void {
+    detail::hashtable_walk_cursor cursor;
+    for (bool done = false; !done; ) {
+      std::lock_guard<hashtable_type> lck{ *impl_ };
+      done = impl_->walk_(cursor, buckets_per_chunk, fn);
+    }
+  }
+
   std::shared_ptr<hashtable_type> impl_;
 };
 
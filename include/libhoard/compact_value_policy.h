@@ -0,0 +1,26 @@
+#pragma once
+
+namespace libhoard {
+
+
+/**
+ * \brief Policy that makes the cache use a compact element layout.
+ * \details
+ * By default, each element reserves space for the pending state and for an error,
+ * next to the mapped value.
+ * With this policy, elements only hold the mapped value inline.
+ * The pending state and errors are allocated separately, for the few elements that need them.
+ *
+ * This saves memory when the mapped type is small,
+ * at the cost of an extra allocation for each resolve and each cached error.
+ *
+ * This policy has no effect if the cache holds smart pointers.
+ *
+ * \note This policy doesn't add base types, instead the hashtable checks
+ * for presence and selects the mapper accordingly.
+ * \ingroup libhoard_api
+ */
+class compact_value_policy {};
+
+
+} /* namespace libhoard */
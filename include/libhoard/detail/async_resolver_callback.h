@@ -1,6 +1,8 @@
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <type_traits>
 #include <utility>
 #include <mutex>
 
@@ -31,7 +33,7 @@ class async_resolver_callback {
     if (called) return false;
 
     if (auto self = weak_self.lock()) {
-      std::lock_guard<HashTable> lck{ *self };
+      const std::unique_lock<HashTable> lck = lock_(*self);
       new_value->assign(std::forward<Args>(args)...);
       self->on_assign_(new_value.get(), true, true);
       called = true;
@@ -47,7 +49,7 @@ class async_resolver_callback {
     if (called) return false;
 
     if (auto self = weak_self.lock()) {
-      std::lock_guard<HashTable> lck{ *self };
+      const std::unique_lock<HashTable> lck = lock_(*self);
       new_value->assign_error(std::move(ex));
       self->on_assign_(new_value.get(), false, true);
       called = true;
@@ -63,7 +65,7 @@ class async_resolver_callback {
     if (called) return false;
 
     if (auto self = weak_self.lock()) {
-      std::lock_guard<HashTable> lck{ *self };
+      const std::unique_lock<HashTable> lck = lock_(*self);
       new_value->cancel();
     } else {
       if (auto pending = new_value->get_pending()) pending->cancel();
@@ -73,10 +75,46 @@ class async_resolver_callback {
   }
 
   private:
+  ///\brief Lock the hashtable, unless this thread already holds the lock.
+  ///\details The resolver is invoked with the lock held, and may complete or drop the callback before it returns.
+  static auto lock_(HashTable& self) -> std::unique_lock<HashTable> {
+    if (self.owns_lock_()) return std::unique_lock<HashTable>(self, std::defer_lock);
+    return std::unique_lock<HashTable>(self);
+  }
+
   std::weak_ptr<HashTable> weak_self;
   detail::refcount_ptr<ValueType, Allocator> new_value;
   bool called = false;
 };
 
 
+template<typename HashTable, typename ValueType, typename Fn, typename = void>
+struct has_start_resolve_
+: std::false_type
+{};
+
+template<typename HashTable, typename ValueType, typename Fn>
+struct has_start_resolve_<HashTable, ValueType, Fn, std::void_t<decltype(std::declval<HashTable&>().start_resolve_(std::declval<ValueType*>(), std::declval<Fn>()))>>
+: std::true_type
+{};
+
+/**
+ * \brief Start the resolver for a pending value.
+ * \details
+ * If the hashtable limits the number of concurrent resolves (using the resolver_concurrency_policy),
+ * the policy decides when \p fn is invoked.
+ * Otherwise, \p fn is invoked immediately.
+ * \param self The hashtable.
+ * \param vptr The pending value that is to be resolved.
+ * \param fn Function that invokes the resolver.
+ */
+template<typename HashTable, typename ValueType, typename Fn>
+auto start_resolve(HashTable& self, ValueType* vptr, Fn&& fn) -> void {
+  if constexpr(has_start_resolve_<HashTable, ValueType, Fn>::value)
+    self.start_resolve_(vptr, std::forward<Fn>(fn));
+  else
+    std::invoke(std::forward<Fn>(fn));
+}
+
+
 } /* namespace libhoard::detail */
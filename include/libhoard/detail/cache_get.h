@@ -6,9 +6,52 @@
 #include <utility>
 #include <variant>
 
+#include "meta.h"
+
 namespace libhoard::detail {
 
 
+template<typename HashTable, typename KeysList, typename = void>
+struct has_front_get_
+: std::false_type
+{};
+
+template<typename HashTable, typename... Keys>
+struct has_front_get_<HashTable, type_list<Keys...>, std::void_t<decltype(std::declval<const HashTable&>().front_get_(std::declval<const Keys&>()...))>>
+: std::true_type
+{};
+
+/**
+ * \brief Look up a value in the front cache of the calling thread.
+ * \details
+ * Only caches with the thread_local_front_policy have a front cache.
+ * This lookup doesn't require the lock.
+ * \return The value, if the front cache holds it. An empty optional otherwise.
+ */
+template<typename HashTable, typename... Keys>
+auto front_get([[maybe_unused]] const HashTable& self, [[maybe_unused]] const Keys&... keys) -> std::optional<typename HashTable::mapped_type> {
+  if constexpr(has_front_get_<HashTable, type_list<Keys...>>::value)
+    return self.front_get_(keys...);
+  else
+    return std::nullopt;
+}
+
+/**
+ * \brief Look up an element in the front cache of the calling thread.
+ * \details
+ * Only caches with the thread_local_front_policy have a front cache.
+ * This lookup doesn't require the lock.
+ * \return Pointer to the element, if the front cache holds it. A null pointer otherwise.
+ */
+template<typename HashTable, typename... Keys>
+auto front_get_handle(const HashTable& self, [[maybe_unused]] const Keys&... keys) -> typename HashTable::value_pointer {
+  if constexpr(has_front_get_<HashTable, type_list<Keys...>>::value)
+    return self.front_get_handle_(keys...);
+  else
+    return typename HashTable::value_pointer(self.get_allocator());
+}
+
+
 ///\brief Facet of cache that performs synchronous get.
 ///\tparam Impl The derived type of cache.
 template<typename Impl, typename HashTableType>
@@ -27,6 +70,7 @@ class cache_get_impl {
       noexcept(noexcept(std::declval<HashTableType&>().get(std::declval<const Keys&>()...)))
   -> std::optional<typename HashTableType::mapped_type> {
     Impl*const self = static_cast<Impl*>(this);
+    if (auto front_value = front_get(*self->impl_, keys...)) return front_value;
     std::lock_guard<HashTableType> lck{ *self->impl_ };
 
     auto v = self->impl_->get(keys...);
@@ -37,6 +81,17 @@ class cache_get_impl {
         return std::make_optional(std::get<1>(std::move(v)));
     }
   }
+
+  ///\brief Look up a value, without copying it.
+  ///\return A handle to the value, which is empty if the value isn't present.
+  template<typename... Keys>
+  auto get_handle(const Keys&... keys) -> typename HashTableType::handle_type {
+    Impl*const self = static_cast<Impl*>(this);
+    if (auto front_ptr = front_get_handle(*self->impl_, keys...)) return typename HashTableType::handle_type(std::move(front_ptr));
+    std::lock_guard<HashTableType> lck{ *self->impl_ };
+
+    return typename HashTableType::handle_type(self->impl_->get_handle(keys...));
+  }
 };
 
 
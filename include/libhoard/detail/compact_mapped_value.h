@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "function_ref.h"
+#include "pending.h"
+#include "refcount.h"
+
+namespace libhoard::detail {
+
+
+/**
+ * \brief Mapper that keeps the common case small.
+ * \details
+ * Drop-in replacement for mapped_value.
+ * The mapped value is stored inline.
+ * The pending state and the error are stored out of line, in a separately allocated side structure,
+ * because most elements hold neither.
+ * The state and the retained flag are packed into a single byte.
+ *
+ * The side structure holds a copy of the allocator, so it can release itself.
+ */
+template<typename T, typename Allocator, typename ErrorType, bool AtomicPins = true>
+class compact_mapped_value {
+  public:
+  using mapped_type = T;
+  using error_type = ErrorType;
+  using pending_type = class pending<mapped_type, Allocator, error_type>;
+  using allocator_type = typename pending_type::allocator_type;
+  using callback_fn = typename pending_type::callback_fn;
+
+  private:
+  enum class state : std::uint8_t { pending, value, expired, error };
+
+  ///\brief Out-of-line storage for the pending state and the error.
+  struct side {
+    using allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<side>;
+
+    template<typename... Args>
+    explicit side(const allocator_type& alloc, Args&&... args);
+
+    allocator_type alloc;
+    std::variant<pending_type, error_type> v;
+  };
+
+  template<typename Table, typename... Args, std::size_t... Indices>
+  compact_mapped_value(const Table& table, std::piecewise_construct_t pc, std::tuple<Args...> args, std::index_sequence<Indices...> indices) noexcept(std::is_nothrow_constructible_v<T, Args...>);
+
+  public:
+  template<typename Table>
+  explicit compact_mapped_value(const Table& table, allocator_type allocator = allocator_type());
+  compact_mapped_value(const compact_mapped_value&) = delete;
+  template<typename Table>
+  compact_mapped_value(const Table& table, std::piecewise_construct_t pc, error_type ex);
+  template<typename Table, typename... Args>
+  compact_mapped_value(const Table& table, std::piecewise_construct_t pc, std::tuple<Args...> args) noexcept(std::is_nothrow_constructible_v<T, Args...>);
+  ~compact_mapped_value() noexcept;
+
+  template<typename... Args>
+  auto assign(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) -> void;
+  auto assign_error(error_type ex) noexcept -> void;
+  auto weaken() noexcept -> void;
+  ///\brief Weaken, but keep the mapped value alive, because a handle refers to it.
+  auto weaken(std::true_type retain_value) noexcept -> void;
+  auto strengthen() noexcept -> bool;
+  auto expired() const noexcept -> bool;
+  auto pending() const noexcept -> bool;
+  auto cancel() noexcept -> void;
+  auto mark_expired() noexcept -> void;
+  ///\brief Mark expired, but keep the mapped value alive, because a handle refers to it.
+  auto mark_expired(std::true_type retain_value) noexcept -> void;
+  auto holds_error() const noexcept -> bool;
+  auto holds_value() const noexcept -> bool;
+
+  auto get_if_matching(function_ref<bool(const mapped_type&)> matcher) const -> std::variant<std::monostate, mapped_type, error_type>;
+  auto get([[maybe_unused]] std::true_type include_pending) noexcept(std::is_nothrow_copy_constructible_v<mapped_type>) -> std::variant<std::monostate, mapped_type, error_type, pending_type*>;
+  auto get([[maybe_unused]] std::false_type include_pending) const noexcept(std::is_nothrow_copy_constructible_v<mapped_type>) -> std::variant<std::monostate, mapped_type, error_type>;
+  auto get_pending() noexcept -> pending_type*;
+  auto matches(function_ref<bool(const mapped_type&)> matcher) const -> bool;
+  ///\brief Address of the mapped value, or nullptr if there is no mapped value.
+  ///\details The mapped value remains at this address, until the compact_mapped_value is destroyed or expired.
+  auto value_ptr() const noexcept -> const mapped_type*;
+  ///\brief Note that a handle uses the mapped value.
+  auto pin() const noexcept -> void;
+  ///\brief Undo a call to pin().
+  auto unpin() const noexcept -> void;
+  ///\brief Test if a handle uses the mapped value.
+  auto pinned() const noexcept -> bool;
+
+  private:
+  template<typename... Args>
+  static auto make_side_(typename side::allocator_type alloc, Args&&... args) -> side*;
+  static auto destroy_side_(side* s) noexcept -> void;
+  ///\brief Destroy the current state, and switch to the expired state.
+  auto clear_() noexcept -> void;
+
+  union {
+    T value_;
+    side* side_;
+  };
+  state state_ : 2;
+  bool retained_ : 1; // Set if the value is expired, but kept alive.
+  mutable pin_count<AtomicPins> pins_; // Number of handles using the mapped value.
+};
+
+
+} /* namespace libhoard::detail */
+
+#include "compact_mapped_value.ii"
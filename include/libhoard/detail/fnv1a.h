@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace libhoard::detail {
+
+
+///\brief FNV-1a hash of \p bytes.
+///\details Unlike std::hash, the result is stable across processes and builds.
+inline auto fnv1a(std::string_view bytes) noexcept -> std::uint64_t {
+  std::uint64_t hash = 0xcbf29ce484222325ull;
+  for (const char c : bytes) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+
+} /* namespace libhoard::detail */
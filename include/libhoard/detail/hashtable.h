@@ -1,22 +1,28 @@
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
 #include <functional>
 #include <iterator>
 #include <memory>
+#include <optional>
+#include <string>
 #include <tuple>
 #include <type_traits>
 #include <utility>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include "basic_hashtable.h"
+#include "compact_mapped_value.h"
 #include "function_ref.h"
 #include "mapped_type.h"
 #include "meta.h"
 #include "traits.h"
 #include "refcount.h"
 #include "value_type.h"
+#include "value_handle.h"
 #include "../allocator.h"
 #include "../equal.h"
 #include "../hash.h"
@@ -25,6 +31,7 @@
 #include "../resolver_policy.h"
 #include "../error_policy.h"
 #include "../pointer_policy.h"
+#include "../compact_value_policy.h"
 
 namespace libhoard::detail {
 
@@ -105,6 +112,17 @@ struct has_error_policy_<error_policy<ErrorType>>
 {};
 
 
+template<typename T>
+struct is_thread_safe_policy_
+: std::false_type
+{};
+
+template<typename Mutex>
+struct is_thread_safe_policy_<basic_thread_safe_policy<Mutex>>
+: std::true_type
+{};
+
+
 template<typename T>
 struct is_pointer_policy_
 : std::false_type
@@ -116,6 +134,17 @@ struct is_pointer_policy_<pointer_policy<WeakPointer, MemberPointer, MemberPoint
 {};
 
 
+template<typename TableBase, typename KeysList, typename = void>
+struct has_nothrow_fallback_get_
+: std::true_type
+{};
+
+template<typename TableBase, typename... Keys>
+struct has_nothrow_fallback_get_<TableBase, type_list<Keys...>, std::void_t<decltype(std::declval<TableBase&>().fallback_get_(std::declval<std::size_t>(), std::declval<const Keys&>()...))>>
+: std::bool_constant<noexcept(std::declval<TableBase&>().fallback_get_(std::declval<std::size_t>(), std::declval<const Keys&>()...))>
+{};
+
+
 ///\brief Small adapter type to wrap elements that are default constructible.
 template<typename T>
 class hashtable_dfl_constructible_
@@ -137,6 +166,8 @@ class hashtable_policy_container
 : public PolicyMap::table_base...
 {
   template<typename, typename, typename> friend class async_resolver_callback; // Allow async_resolver_policy to emit the on_asign_ event.
+  template<typename, typename> friend class queue; // Allow the queue to emit the on_evict_ event.
+  template<typename HashTable, typename VType> friend auto fail_resolve_timeout(HashTable& self, VType* vptr) noexcept -> void; // Allow resolve_timeout_policy to emit the on_assign_ event.
 
   public:
   static constexpr bool has_policy_removal_check = std::disjunction_v<has_policy_removal_check_<typename PolicyMap::table_base>...>;
@@ -149,6 +180,12 @@ class hashtable_policy_container
 
   ~hashtable_policy_container() noexcept;
 
+  ///\brief Dispatch an on-reserve event.
+  ///\details
+  ///Fires before an element is linked.
+  ///Unlike the other events, policies may throw from it:
+  ///it lets them allocate what they need during the noexcept events that follow.
+  auto on_reserve_(ValueType* vptr) -> void;
   ///\brief Dispatch an on-create event.
   auto on_create_(ValueType* vptr) noexcept -> void;
   ///\brief Dispatch an on-assign event.
@@ -159,8 +196,28 @@ class hashtable_policy_container
   auto on_hit_(ValueType* vptr) noexcept -> void;
   ///\brief Dispatch an on-miss event.
   auto on_miss_() noexcept -> void;
+  ///\brief Dispatch an on-evict event.
+  ///\details Fires when a value is about to be expired, because the cache needs to shrink.
+  auto on_evict_(ValueType* vptr) noexcept -> void;
+  ///\brief Dispatch an on-expire event.
+  ///\details Fires when the values matching a key are explicitly expired.
+  auto on_expire_(std::size_t hash, function_ref<bool(const typename ValueType::key_type&)> matcher) noexcept -> void;
+  ///\brief Dispatch an on-expire-all event.
+  ///\details Fires when all values are explicitly expired.
+  auto on_expire_all_() noexcept -> void;
   ///\brief Perform maintenance.
   auto on_maintenance_() noexcept -> void;
+  /**
+   * \brief Ask policies for a value that is not held by the hashtable.
+   * \details
+   * Invoked on a miss, before the resolver is consulted.
+   * Policies are asked in order, the first policy that produces a value wins.
+   * \return The value produced by a policy, or an empty optional if no policy produced a value.
+   */
+  template<typename... Keys>
+  auto fallback_get_(std::size_t hash, const Keys&... keys)
+      noexcept(std::conjunction_v<has_nothrow_fallback_get_<typename PolicyMap::table_base, type_list<Keys...>>...>)
+  -> std::optional<typename ValueType::mapped_type>;
 
   ///\brief Check in with policies to figure out how many elements must be removed.
   ///\return Tuple with number of elements that is to be expired.
@@ -191,7 +248,12 @@ struct select_mapper_impl_<T, PoliciesTypeList, false> {
   using error_policy = typename PoliciesTypeList::template filter_t<has_error_policy_>::template apply_t<select_single_element_t>;
   using error_type = typename error_policy::error_type;
 
-  using type = mapped_value<T, allocator_type, error_type>;
+  static constexpr bool atomic_pins = !PoliciesTypeList::template has_type_v<thread_unsafe_policy>;
+
+  using type = std::conditional_t<
+      PoliciesTypeList::template has_type_v<compact_value_policy>,
+      compact_mapped_value<T, allocator_type, error_type, atomic_pins>,
+      mapped_value<T, allocator_type, error_type, atomic_pins>>;
 };
 
 template<typename T, typename PoliciesTypeList>
@@ -220,6 +282,31 @@ struct policy_and_table_base {
 };
 
 
+///\brief Selects the hash function, if no hash policy is present.
+template<typename KeyType>
+struct default_hash_ {
+  using type = std::hash<KeyType>;
+};
+
+///\brief Strings use a transparent hash function, so they can be looked up using string views.
+template<typename CharT, typename Alloc>
+struct default_hash_<std::basic_string<CharT, std::char_traits<CharT>, Alloc>> {
+  using type = transparent_string_hash<CharT>;
+};
+
+///\brief Selects the equality function, if no equal policy is present.
+template<typename KeyType>
+struct default_equal_ {
+  using type = std::equal_to<KeyType>;
+};
+
+///\brief Strings use a transparent equality function, so they can be compared with string views.
+template<typename CharT, typename Traits, typename Alloc>
+struct default_equal_<std::basic_string<CharT, Traits, Alloc>> {
+  using type = std::equal_to<>;
+};
+
+
 template<typename KeyType, typename T, typename... Policies>
 struct hashtable_helper_ {
   static inline constexpr bool is_identity_map = std::is_same_v<identity_t, KeyType>;
@@ -232,12 +319,12 @@ struct hashtable_helper_ {
   using maybe_default_equal = std::conditional_t<
       has_equal_policy,
       type_list<>,
-      type_list<equal<std::equal_to<std::conditional_t<is_identity_map, T, KeyType>>>>>;
+      type_list<equal<typename default_equal_<std::conditional_t<is_identity_map, T, KeyType>>::type>>>;
 
   using maybe_default_hash = std::conditional_t<
       has_hash_policy,
       type_list<>,
-      type_list<hash<std::hash<std::conditional_t<is_identity_map, T, KeyType>>>>>;
+      type_list<hash<typename default_hash_<std::conditional_t<is_identity_map, T, KeyType>>::type>>>;
 
   using allocator_policy = typename std::conditional_t<
       has_allocator_policy,
@@ -253,11 +340,17 @@ struct hashtable_helper_ {
   ///\details
   ///Takes the dependencies type_list from the \p Policies.
   ///Ensures its set is distinct and none of the Policies are included.
-  using policy_dependencies = typename type_list<>::extend_t<typename dependent_policies_<Policies>::type...>::template exclude_t<type_list<Policies...>>::distinct_t;
+  ///A thread_safe_policy dependency is satisfied by a basic_thread_safe_policy with any mutex.
+  using policy_dependencies = typename type_list<>::extend_t<typename dependent_policies_<Policies>::type...>::template exclude_t<
+      type_list<Policies...>,
+      std::conditional_t<
+          std::disjunction_v<is_thread_safe_policy_<Policies>...>,
+          type_list<thread_safe_policy>,
+          type_list<>>>::distinct_t;
 
   static inline constexpr bool has_thread_safe_policy = std::disjunction_v<
-      typename type_list<Policies...>::template has_type_t<thread_safe_policy>,
-      typename policy_dependencies::template has_type_t<thread_safe_policy>,
+      is_thread_safe_policy_<Policies>...,
+      typename policy_dependencies::template transform_t<is_thread_safe_policy_>::template apply_t<std::disjunction>,
       typename type_list<Policies...>::template has_type_t<thread_unsafe_policy>,
       typename policy_dependencies::template has_type_t<thread_unsafe_policy>>;
   using maybe_extra_mutex_policies = std::conditional_t<
@@ -286,8 +379,12 @@ struct hashtable_helper_ {
   ///\brief List of types that the value type must inherit from according to policies.
   using vt_base_types = typename all_policies::template transform_t<figure_out_hashtable_value_base_>::template remove_all_t<void>;
 
+  ///\brief Reference counter of the value type.
+  ///\details Caches with the thread_unsafe_policy are used from one thread at a time, so they don't need atomic operations.
+  using refcount_type = basic_refcount<!all_policies::template has_type_v<thread_unsafe_policy>>;
+
   ///\brief The value type used in the hashtable.
-  using value_type = typename type_list<KeyType, mapper, hashtable_dfl_constructible_<basic_hashtable_element>, hashtable_dfl_constructible_<refcount>>::template extend_t<vt_base_types>::template apply_t<libhoard::detail::value_type>;
+  using value_type = typename type_list<KeyType, mapper, hashtable_dfl_constructible_<basic_hashtable_element>, hashtable_dfl_constructible_<refcount_type>>::template extend_t<vt_base_types>::template apply_t<libhoard::detail::value_type>;
   ///\brief Key type of the cache.
   using key_type = typename value_type::key_type;
   ///\brief Mapped type of the cache.
@@ -438,6 +535,26 @@ template<typename... Args>
 inline constexpr bool arg_pack_starts_with_allocator_arg_v = arg_pack_starts_with_allocator_arg_<std::remove_cv_t<std::remove_reference_t<Args>>...>::value;
 
 
+///\brief Position of a walk over a hashtable, that spans multiple lock acquisitions.
+class hashtable_walk_cursor {
+  template<typename KeyType, typename T, typename... Policies> friend class hashtable;
+
+  private:
+  ///\brief Buckets [0, end) were visited, while the table had bucket_count buckets.
+  struct visited_range {
+    std::size_t bucket_count;
+    std::size_t end;
+  };
+
+  ///\brief Test if the element with hash code \p hash was visited before the table was rehashed.
+  auto visited_before_rehash_(std::size_t hash) const noexcept -> bool;
+
+  std::vector<visited_range> visited_;
+  std::size_t bucket_count_ = 0;
+  std::size_t next_ = 0;
+};
+
+
 /**
  * \brief Hashtable that drives the cache primitives.
  * \details
@@ -469,6 +586,7 @@ class hashtable
   using allocator_type = typename helper_type::allocator_type;
   using size_type = typename bht::size_type;
   using value_pointer = refcount_ptr<value_type, allocator_type>;
+  using handle_type = value_handle<value_type, allocator_type>;
   using callback_fn = typename value_type::callback_fn;
   using iterator = typename helper_type::iterator;
   using const_iterator = typename helper_type::const_iterator;
@@ -530,7 +648,32 @@ class hashtable
       std::is_nothrow_copy_constructible_v<mapped_type> && std::is_nothrow_copy_constructible_v<error_type>)
   -> std::variant<std::monostate, mapped_type, error_type>;
 
+  /**
+   * \brief Find the element holding the value for a key.
+   * \details
+   * Like get_if_exists(), this does not perform on-hit/on-miss events.
+   * \return The element holding a value or error for the key, or nullptr if there is none.
+   */
+  template<typename... Keys>
+  auto find_if_exists(const Keys&... keys) const -> const value_type*;
+
   private:
+  /**
+   * \brief Find an element in the cache.
+   * \details
+   * Walks the bucket for \p hash, cleaning up expired elements it passes by.
+   * The \p probe is invoked for each element with a matching hash code.
+   * The first element for which the probe returns true, and that isn't expired, is returned.
+   *
+   * Invokes the `on hit` and `on miss` events.
+   *
+   * \note The probe is invoked before the element is checked for expiry.
+   * This way, if the probe acquires the value, it really wasn't expired.
+   * \return The found element, or nullptr if no element was found.
+   */
+  template<typename Probe>
+  auto find_(std::size_t hash, Probe&& probe) -> value_type*;
+
   /**
    * \brief Retrieve a value from the cache.
    * \details
@@ -555,9 +698,20 @@ class hashtable
       &&
       noexcept(std::invoke(std::declval<const typename helper_type::ht_base&>().hash, std::declval<const Keys&>()...))
       &&
+      noexcept(std::declval<hashtable&>().fallback_get_(std::declval<std::size_t>(), std::declval<const Keys&>()...))
+      &&
       std::is_nothrow_copy_constructible_v<mapped_type> && std::is_nothrow_copy_constructible_v<error_type>)
   -> std::variant<std::monostate, mapped_type, error_type>;
 
+  /**
+   * \brief Retrieve the element for a key, without copying its value.
+   * \details
+   * Like get(), this will consult fallbacks and the resolver, if the key isn't in the cache.
+   * \return Pointer to the element holding a value or error, or nullptr if there is none.
+   */
+  template<typename... Keys>
+  auto get_handle(const Keys&... keys) -> value_pointer;
+
   template<typename CompletionCallback, typename... Keys>
   auto async_get(CompletionCallback&& callback, const Keys&... keys) -> void;
 
@@ -582,19 +736,22 @@ class hashtable
   template<typename... Keys>
   auto expire(const Keys&... keys) -> void;
 
+  /**
+   * \brief Remove an element from the cache.
+   * \details
+   * Used by policies that evict elements themselves.
+   * Unlike marking the element expired, this frees its space in the cache immediately.
+   *
+   * \note Must not be called while a bucket is being scanned, for example from the on-hit event.
+   */
+  auto unlink_element_(value_type* vptr) noexcept -> void;
+
   template<typename... Args>
   auto allocate_value_type(Args&&... args) -> value_pointer;
   auto value_to_refpointer(value_type* vptr) const -> value_pointer;
 
   auto link(std::size_t hash, value_pointer vptr) -> void;
 
-  /**
-   * \brief Create a callback that'll invoke the on_assign_ event.
-   * \param vptr Pointer to the value type for which the callback will invoke the on-assign event.
-   * \return Callback that'll invoke on-assign.
-   */
-  auto assign_value_callback(const value_pointer& vptr) -> callback_fn;
-
   auto begin() noexcept -> iterator;
   auto end() noexcept -> iterator;
   auto begin() const noexcept -> const_iterator;
@@ -609,6 +766,19 @@ class hashtable
   auto emplace(KeyArg&& key_arg, MappedArg&& mapped_arg)
   -> std::enable_if_t<std::is_constructible_v<key_type, KeyArg> && std::is_constructible_v<mapped_type, MappedArg>>;
 
+  /**
+   * \brief Emplace a sequence of key-value pairs.
+   * \details
+   * Has the same effect as calling emplace() for each pair in turn.
+   * But the table is grown only once (if the iterators are forward iterators, and no policy limits the size),
+   * and maintenance runs only once, at the end.
+   * Except for eviction: once the policies need elements removed, eviction runs after each element, like emplace() does.
+   *
+   * \param first,last Range of pair-like elements. `std::get<0>` of an element is the key, and `std::get<1>` is the mapped value.
+   */
+  template<typename Iter>
+  auto emplace_many(Iter first, Iter last) -> void;
+
   template<typename... KeyArgs, typename... MappedArgs, bool IncludePending>
   auto get_or_emplace(std::piecewise_construct_t pc, std::tuple<KeyArgs...> key_args, std::tuple<MappedArgs...> mapped_args, std::integral_constant<bool, IncludePending> include_pending)
   -> std::conditional_t<
@@ -627,6 +797,26 @@ class hashtable
   ///\brief Count number of not-expired elements in the cache.
   auto count() const noexcept -> size_type;
 
+  /**
+   * \brief Visit the elements in the next few buckets of a walk over the table.
+   * \details
+   * The walk visits each element that holds a value, and isn't expired.
+   * Pending and expired elements are skipped.
+   * Expired elements that are passed by, are removed.
+   *
+   * The lock may be released between calls.
+   * If the table is rehashed in between, elements that were already visited are skipped.
+   * Each element that is in the table for the whole walk, is visited exactly once.
+   *
+   * \param cursor The position of the walk.
+   * \param max_buckets The maximum number of buckets to visit.
+   * \param fn Invoked as `fn(const key_type&, const mapped_type&)` for each element.
+   * If it returns true, the element is erased, as if by `expire()`.
+   * \return True if the walk has completed.
+   */
+  template<typename Fn>
+  auto walk_(hashtable_walk_cursor& cursor, size_type max_buckets, Fn&& fn) -> bool;
+
   private:
   auto maintenance_() noexcept -> void;
   auto bucket_for_hash_(std::size_t hash) noexcept -> typename helper_type::range;
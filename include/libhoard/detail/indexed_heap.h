@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace libhoard::detail {
+
+
+template<typename T, typename Tag, typename Compare, typename Allocator> class indexed_heap;
+
+
+/**
+ * \brief Hook for elements of an indexed_heap.
+ * \details
+ * The hook records the position of the element in the heap,
+ * so the element can be removed without searching for it.
+ *
+ * Copying or moving an element doesn't copy its position:
+ * the copy is not in the heap.
+ * \tparam Tag Tag type, allowing an element to be in multiple heaps.
+ */
+template<typename Tag>
+class indexed_heap_link {
+  template<typename T, typename Tag_, typename Compare, typename Allocator> friend class indexed_heap;
+
+  protected:
+  indexed_heap_link() noexcept = default;
+  indexed_heap_link(const indexed_heap_link& y) noexcept;
+  indexed_heap_link(indexed_heap_link&& y) noexcept;
+  ~indexed_heap_link() noexcept = default;
+  auto operator=(const indexed_heap_link& y) noexcept -> indexed_heap_link&;
+  auto operator=(indexed_heap_link&& y) noexcept -> indexed_heap_link&;
+
+  public:
+  ///\brief Test if this element is in a heap.
+  auto is_linked() const noexcept -> bool;
+
+  private:
+  static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  std::size_t heap_index_ = npos;
+};
+
+
+/**
+ * \brief Intrusive binary min-heap, supporting removal of arbitrary elements.
+ * \details
+ * The heap holds pointers to elements, which must derive from indexed_heap_link<Tag>.
+ * Insertion, removal and re-ordering of an element are O(log n).
+ *
+ * The heap doesn't own its elements.
+ * Elements must be removed from the heap before they are destroyed.
+ * \tparam T The element type.
+ * \tparam Tag Tag type, selecting the indexed_heap_link of the element.
+ * \tparam Compare Ordering of elements: the least element is at the top of the heap.
+ * \tparam Allocator Allocator for the heap storage.
+ */
+template<typename T, typename Tag, typename Compare = std::less<T>, typename Allocator = std::allocator<T*>>
+class indexed_heap {
+  private:
+  using link = indexed_heap_link<Tag>;
+
+  public:
+  explicit indexed_heap(Compare cmp = Compare(), const Allocator& allocator = Allocator());
+  indexed_heap(const indexed_heap&) = delete;
+  auto operator=(const indexed_heap&) -> indexed_heap& = delete;
+
+  auto empty() const noexcept -> bool;
+  auto size() const noexcept -> std::size_t;
+  ///\brief Number of elements the heap can hold, before it has to grow.
+  auto capacity() const noexcept -> std::size_t;
+  ///\brief Least element in the heap.
+  ///\pre !empty()
+  auto top() const noexcept -> T*;
+
+  ///\brief Make room for \p n elements.
+  ///\details After this, push() won't allocate, until the heap holds \p n elements.
+  auto reserve(std::size_t n) -> void;
+
+  ///\brief Add an element to the heap.
+  ///\details Only throws if the heap has to grow, see reserve().
+  ///\pre !elem->is_linked()
+  auto push(T* elem) -> void;
+  ///\brief Remove the least element from the heap.
+  ///\pre !empty()
+  auto pop() noexcept -> T*;
+  ///\brief Remove an element from the heap.
+  ///\pre elem is in this heap.
+  auto erase(T* elem) noexcept -> void;
+  ///\brief Restore the heap order, after the ordering key of \p elem changed.
+  ///\pre elem is in this heap.
+  auto update(T* elem) noexcept -> void;
+
+  private:
+  static auto index_(const T* elem) noexcept -> std::size_t&;
+  auto place_(std::size_t idx, T* elem) noexcept -> void;
+  auto sift_up_(std::size_t idx) noexcept -> void;
+  auto sift_down_(std::size_t idx) noexcept -> void;
+
+  std::vector<T*, Allocator> data_;
+  Compare cmp_;
+};
+
+
+} /* namespace libhoard::detail */
+
+#include "indexed_heap.ii"
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <tuple>
 #include <type_traits>
@@ -9,6 +10,7 @@
 #include "function_ref.h"
 #include "identity_fn.h"
 #include "pending.h"
+#include "refcount.h"
 
 namespace libhoard::detail {
 
@@ -16,7 +18,7 @@ namespace libhoard::detail {
 struct expired_t {};
 
 
-template<typename T, typename Allocator, typename ErrorType>
+template<typename T, typename Allocator, typename ErrorType, bool AtomicPins = true>
 class mapped_value {
   public:
   using mapped_type = T;
@@ -44,11 +46,15 @@ class mapped_value {
   auto assign(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) -> void;
   auto assign_error(error_type ex) noexcept -> void;
   auto weaken() noexcept -> void;
+  ///\brief Weaken, but keep the mapped value alive, because a handle refers to it.
+  auto weaken(std::true_type retain_value) noexcept -> void;
   auto strengthen() noexcept -> bool;
   auto expired() const noexcept -> bool;
   auto pending() const noexcept -> bool;
   auto cancel() noexcept -> void;
   auto mark_expired() noexcept -> void;
+  ///\brief Mark expired, but keep the mapped value alive, because a handle refers to it.
+  auto mark_expired(std::true_type retain_value) noexcept -> void;
   auto holds_error() const noexcept -> bool;
   auto holds_value() const noexcept -> bool;
 
@@ -57,9 +63,24 @@ class mapped_value {
   auto get([[maybe_unused]] std::false_type include_pending) const noexcept(std::is_nothrow_copy_constructible_v<mapped_type>) -> std::variant<std::monostate, mapped_type, error_type>;
   auto get_pending() noexcept -> pending_type*;
   auto matches(function_ref<bool(const mapped_type&)> matcher) const -> bool;
+  ///\brief Address of the mapped value, or nullptr if there is no mapped value.
+  ///\details The mapped value remains at this address, until the mapped_value is destroyed or expired.
+  auto value_ptr() const noexcept -> const mapped_type*;
+  ///\brief Note that a handle uses the mapped value.
+  auto pin() const noexcept -> void;
+  ///\brief Undo a call to pin().
+  auto unpin() const noexcept -> void;
+  ///\brief Test if a handle uses the mapped value.
+  auto pinned() const noexcept -> bool;
 
   private:
   variant_type value_;
+  ///\brief Set if the value is expired, but kept alive.
+  ///\details Atomic, because the thread_local_front_policy reads it without the lock.
+  std::atomic<bool> retained_{ false };
+  ///\brief Number of handles using the mapped value.
+  ///\details Kept here, rather than in the element, so it fits in the padding after retained_.
+  mutable pin_count<AtomicPins> pins_;
 };
 
 
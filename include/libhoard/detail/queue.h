@@ -34,10 +34,15 @@ class basic_queue {
 
     private:
     bool hot_;
+    bool weak_ = false; // Set if the element was weakened and has not been strengthened since.
   };
 
   protected:
-  using callback = void(value_base*) noexcept;
+  ///\brief Callback that strengthens an element. Returns true if the element is strong afterwards.
+  using callback = bool(value_base*) noexcept;
+
+  ///\brief Maximum number of elements visited by a single sweep for dead weakened elements.
+  static constexpr std::size_t sweep_batch = 4;
 
   basic_queue() noexcept = default;
   basic_queue(const basic_queue&) noexcept = delete;
@@ -73,9 +78,21 @@ class basic_queue {
   ///\brief Invariant maintained by the queue.
   auto invariant() const noexcept -> bool;
 
+  ///\brief Number of elements that are weakened.
+  auto weak_size() const noexcept -> std::size_t;
+
   private:
+  ///\brief Strengthen \p v, and clear its weak flag if that succeeds.
+  auto strengthen_(value_base* v, callback* strengthen) noexcept -> void;
+  ///\brief Move the sweep cursor off \p v, so \p v can be moved or unlinked.
+  auto step_sweep_off_(value_base* v) noexcept -> void;
+
   linked_list<value_base, basic_queue> q_;
   linked_list<value_base, basic_queue>::iterator midpoint_ = q_.begin();
+  // The sweep walks the cold zone, from the back of the queue towards the midpoint.
+  // The next element to visit is the one preceding the cursor.
+  linked_list<value_base, basic_queue>::iterator sweep_ = q_.end();
+  std::size_t weak_count_ = 0;
   bool odd_sized_ = false;
 };
 
@@ -108,6 +125,7 @@ class queue
    *
    * \note If the hashtable has the weaken_policy instead of expiring elements
    * they'll be weakened instead.
+   * Elements that are already weakened are skipped, and don't count towards \p count.
    */
   auto lru_expire_(std::size_t count) noexcept -> void;
 
@@ -116,7 +134,18 @@ class queue
   auto on_create_(value_base* v) noexcept -> void;
   auto on_hit_(value_base* v) noexcept -> void;
 
+  /**
+   * \brief On-maintenance event acceptor.
+   * \details
+   * If the hashtable has the weaken_policy, visits a few cold elements,
+   * and removes weakened elements whose value has died.
+   * Successive calls continue where the previous call left off,
+   * so the whole cold zone is swept over time.
+   */
+  auto on_maintenance_() noexcept -> void;
+
   using basic_queue::invariant;
+  using basic_queue::weak_size;
 };
 
 /**
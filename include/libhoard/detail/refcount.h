@@ -2,6 +2,7 @@
 
 #include <utility>
 #include <cstddef>
+#include <cstdint>
 #include <atomic>
 #include <type_traits>
 #include <memory>
@@ -9,34 +10,90 @@
 namespace libhoard::detail {
 
 
-class refcount;
+template<bool Atomic> class basic_refcount;
 template<typename T, typename Allocator> class refcount_ptr;
 
+///\brief Reference counter that may be shared between threads.
+using refcount = basic_refcount<true>;
+///\brief Reference counter that is only used by a single thread at a time.
+using unsynchronized_refcount = basic_refcount<false>;
+
 
 ///\brief Increment reference counter in \p r
-auto refcount_inc(const refcount* r) noexcept -> void;
+template<bool Atomic>
+auto refcount_inc(const basic_refcount<Atomic>* r) noexcept -> void;
 ///\brief Decrement reference counter in \p r
 ///\return True if the reference counter reached zero.
-auto refcount_dec(const refcount* r) noexcept -> bool;
+template<bool Atomic>
+auto refcount_dec(const basic_refcount<Atomic>* r) noexcept -> bool;
+///\brief Read the reference counter in \p r
+///\details The counter may change concurrently, so the result is only a snapshot.
+template<bool Atomic>
+auto refcount_load(const basic_refcount<Atomic>* r) noexcept -> std::size_t;
+
+///\brief Test if \p T derives from one of the reference counters.
+template<typename T>
+struct is_refcounted
+: std::bool_constant<
+    std::is_convertible_v<const T*, const refcount*> ||
+    std::is_convertible_v<const T*, const unsynchronized_refcount*>>
+{};
+
+template<typename T>
+inline constexpr bool is_refcounted_v = is_refcounted<T>::value;
 
 template<typename T, typename Allocator, typename... Args>
 auto allocate_refcount(Allocator&& allocator, Args&&... args) -> refcount_ptr<T, std::decay_t<Allocator>>;
 
 
-class refcount {
-  friend auto refcount_inc(const refcount* r) noexcept -> void;
-  friend auto refcount_dec(const refcount* r) noexcept -> bool;
+/**
+ * \brief Intrusive reference counter.
+ * \details
+ * If \p Atomic is false, the counter is a plain integer.
+ * That is only safe if all references are used from a single thread at a time,
+ * which is the case for caches with the thread_unsafe_policy.
+ * \tparam Atomic If true, the counter may be used concurrently.
+ */
+template<bool Atomic>
+class basic_refcount {
+  template<bool A> friend auto refcount_inc(const basic_refcount<A>* r) noexcept -> void;
+  template<bool A> friend auto refcount_dec(const basic_refcount<A>* r) noexcept -> bool;
+  template<bool A> friend auto refcount_load(const basic_refcount<A>* r) noexcept -> std::size_t;
 
   protected:
-  refcount() noexcept;
-  refcount(const refcount&) noexcept;
-  refcount(refcount&&) noexcept;
-  ~refcount() noexcept;
-  auto operator=(const refcount&) noexcept -> refcount&;
-  auto operator=(refcount&&) noexcept -> refcount&;
+  basic_refcount() noexcept;
+  basic_refcount(const basic_refcount&) noexcept;
+  basic_refcount(basic_refcount&&) noexcept;
+  ~basic_refcount() noexcept;
+  auto operator=(const basic_refcount&) noexcept -> basic_refcount&;
+  auto operator=(basic_refcount&&) noexcept -> basic_refcount&;
 
   private:
-  mutable std::atomic<std::size_t> n_{ 0u };
+  using counter_type = std::conditional_t<Atomic, std::atomic<std::size_t>, std::size_t>;
+
+  mutable counter_type n_{ 0u };
+};
+
+
+/**
+ * \brief Counts the handles that use the mapped value of an element.
+ * \details
+ * The counter is only 32 bits wide, so that mappers can keep it in their padding.
+ * \tparam Atomic If true, the counter may be used concurrently.
+ */
+template<bool Atomic>
+class pin_count {
+  public:
+  auto inc() noexcept -> void;
+  auto dec() noexcept -> void;
+  ///\brief Test if the counter is non-zero.
+  ///\details The counter may change concurrently, so the result is only a snapshot.
+  auto nonzero() const noexcept -> bool;
+
+  private:
+  using counter_type = std::conditional_t<Atomic, std::atomic<std::uint32_t>, std::uint32_t>;
+
+  counter_type n_{ 0u };
 };
 
 
@@ -54,8 +111,8 @@ class refcount_ptr {
   friend auto allocate_refcount(AllocatorU&& allocator, Args&&... args) -> refcount_ptr<U, std::decay_t<AllocatorU>>;
   template<typename U, typename AllocatorU> friend class refcount_ptr;
 
-  static_assert(std::is_convertible_v<std::remove_const_t<T>*, refcount*>,
-      "T must derive (publicly, non-ambiguously) from refcount");
+  static_assert(is_refcounted_v<T>,
+      "T must derive (publicly, non-ambiguously) from refcount or unsynchronized_refcount");
   static_assert(std::is_same_v<typename std::allocator_traits<Allocator>::value_type, std::remove_const_t<T>>,
       "Allocator must be an allocator of T");
 
@@ -105,9 +162,9 @@ class refcount_ptr {
 
   private:
   // Invokes refcount_inc, avoiding ADL.
-  static auto inc_(const refcount* r) noexcept -> void;
+  static auto inc_(const element_type* r) noexcept -> void;
   // Invokes refcount_dec, avoiding ADL.
-  static auto dec_(const refcount* r) noexcept -> bool;
+  static auto dec_(const element_type* r) noexcept -> bool;
 
   allocator_type alloc_;
   element_type* ptr_ = nullptr;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mutex>
 #include <tuple>
 
 namespace libhoard::detail {
@@ -41,6 +42,20 @@ class refresh_impl_policy::table_base {
   table_base(const refresh_impl_policy& policy, const Allocator& allocator);
 
   auto refresh(ValueType* raw_value_ptr) -> void;
+
+  /**
+   * \brief Refresh a value, releasing the lock while the resolver runs.
+   * \details
+   * With a synchronous resolver, the lock is released while the resolver runs,
+   * so lookups and other refreshes can proceed in the meantime.
+   * The old value keeps being served until the new value is installed.
+   * If the old value is removed while the resolver runs, the new value is discarded.
+   *
+   * With an asynchronous resolver, this is the same as `refresh(raw_value_ptr)`.
+   * \param raw_value_ptr The value to refresh.
+   * \param lck The lock on the hashtable. Must be locked.
+   */
+  auto refresh(ValueType* raw_value_ptr, std::unique_lock<HashTable>& lck) -> void;
 };
 
 
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "refcount.h"
+
+namespace libhoard::detail {
+
+
+/**
+ * \brief Handle to a value in the cache.
+ * \details
+ * The handle refers to the mapped value inside the cache element, instead of holding a copy.
+ * It keeps the element, and the mapped value, alive until the handle is released.
+ * This remains so, even if the element is evicted or replaced in the meantime.
+ *
+ * The handle pins the element (see value_type::pin()), so that expiring the element keeps the mapped value.
+ * A handle must be created while holding the cache lock, or from an element that is already pinned.
+ *
+ * Handles can be used and released without holding the cache lock.
+ * But the mapped value is shared with the cache, and must not be modified.
+ *
+ * \note
+ * The last handle to an evicted element destroys the element.
+ * When that happens, the allocator of the cache is used without holding the cache lock.
+ *
+ * \tparam ValueType The value type of the hashtable.
+ * \tparam Allocator The allocator of the hashtable.
+ */
+template<typename ValueType, typename Allocator>
+class value_handle {
+  public:
+  using mapped_type = typename ValueType::mapped_type;
+  using pointer = refcount_ptr<const ValueType, Allocator>;
+
+  ///\brief Create an empty handle.
+  value_handle() = default;
+  ///\brief Create a handle for the mapped value of \p ptr.
+  ///\details If \p ptr doesn't hold a mapped value, the handle will be empty.
+  explicit value_handle(pointer ptr) noexcept;
+  value_handle(const value_handle& y) noexcept;
+  value_handle(value_handle&& y) noexcept;
+  ~value_handle() noexcept;
+  auto operator=(const value_handle& y) noexcept -> value_handle&;
+  auto operator=(value_handle&& y) noexcept -> value_handle&;
+
+  ///\brief Test if the handle refers to a value.
+  explicit operator bool() const noexcept;
+  ///\brief Address of the mapped value, or nullptr if the handle is empty.
+  auto get() const noexcept -> const mapped_type*;
+  auto operator*() const noexcept -> const mapped_type&;
+  auto operator->() const noexcept -> const mapped_type*;
+
+  ///\brief Release the value.
+  auto reset() noexcept -> void;
+
+  private:
+  pointer ptr_;
+  const mapped_type* value_ = nullptr;
+};
+
+
+} /* namespace libhoard::detail */
+
+#include "value_handle.ii"
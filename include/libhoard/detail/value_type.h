@@ -15,6 +15,18 @@
 namespace libhoard::detail {
 
 
+///\brief Test if the mapper can keep its value alive after it expires.
+template<typename Mapper, typename = void>
+struct mapper_retains_value_
+: std::false_type
+{};
+
+template<typename Mapper>
+struct mapper_retains_value_<Mapper, std::void_t<decltype(std::declval<Mapper&>().mark_expired(std::true_type()))>>
+: std::true_type
+{};
+
+
 template<typename KeyType, typename Mapper, typename... BaseTypes>
 class value_type
 : public BaseTypes...
@@ -68,7 +80,15 @@ class value_type
 
   auto pending() const noexcept -> bool;
   auto expired() const noexcept -> bool;
+  /**
+   * \brief Mark the value as expired.
+   * \details
+   * If the element is pinned, a handle is using the mapped value.
+   * In that case, the mapped value is kept alive until this is destroyed.
+   */
   auto mark_expired() noexcept -> void;
+  ///\brief Weaken the value.
+  ///\details Like mark_expired(), the mapped value is kept alive if a handle uses it.
   auto weaken() noexcept -> void;
   auto strengthen() noexcept -> bool;
   auto cancel() noexcept -> void;
@@ -76,10 +96,22 @@ class value_type
   auto holds_error() const noexcept -> bool;
   auto get_pending() noexcept -> pending_type*;
   auto key() const -> std::optional<key_type>;
+  ///\brief Address of the mapped value, or nullptr if there is no mapped value.
+  auto value_ptr() const noexcept -> const mapped_type*;
+  ///\brief Record that a handle uses the mapped value.
+  ///\details While the element is pinned, expiring or weakening it keeps the mapped value alive.
+  ///The counter lives in the mapper; if the mapper can't retain its value, this does nothing.
+  auto pin() const noexcept -> void;
+  ///\brief Undo a call to pin().
+  auto unpin() const noexcept -> void;
+
 
   template<typename... Args>
   auto assign(Args&&... args) noexcept(noexcept(std::declval<mapper&>().assign(std::declval<Args>()...))) -> void;
   auto assign_error(error_type ex) noexcept -> void;
+
+  private:
+  auto retain_value_() const noexcept -> bool;
 };
 
 template<typename Mapper, typename... BaseTypes>
@@ -118,7 +150,15 @@ class value_type<identity_t, Mapper, BaseTypes...>
 
   auto pending() const noexcept -> bool;
   auto expired() const noexcept -> bool;
+  /**
+   * \brief Mark the value as expired.
+   * \details
+   * If the element is pinned, a handle is using the mapped value.
+   * In that case, the mapped value is kept alive until this is destroyed.
+   */
   auto mark_expired() noexcept -> void;
+  ///\brief Weaken the value.
+  ///\details Like mark_expired(), the mapped value is kept alive if a handle uses it.
   auto weaken() noexcept -> void;
   auto strengthen() noexcept -> bool;
   auto cancel() noexcept -> void;
@@ -126,6 +166,17 @@ class value_type<identity_t, Mapper, BaseTypes...>
   auto holds_error() const noexcept -> bool;
   auto get_pending() noexcept -> pending_type*;
   auto key() const -> std::optional<key_type>;
+  ///\brief Address of the mapped value, or nullptr if there is no mapped value.
+  auto value_ptr() const noexcept -> const mapped_type*;
+  ///\brief Record that a handle uses the mapped value.
+  ///\details While the element is pinned, expiring or weakening it keeps the mapped value alive.
+  ///The counter lives in the mapper; if the mapper can't retain its value, this does nothing.
+  auto pin() const noexcept -> void;
+  ///\brief Undo a call to pin().
+  auto unpin() const noexcept -> void;
+
+  private:
+  auto retain_value_() const noexcept -> bool;
 };
 
 
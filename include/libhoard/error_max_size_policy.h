@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+
+#include "negative_cache_policy.h"
+#include "detail/linked_list.h"
+#include "detail/meta.h"
+
+namespace libhoard {
+
+
+/**
+ * \brief Policy that restricts the number of errors in the cache.
+ * \details
+ * Errors are tracked in their own least-recently-used list,
+ * separate from the values.
+ * Once more than \p max_errors errors are cached,
+ * the least recently used error is removed from the cache.
+ *
+ * Values never count towards this limit, and are never expired by this policy.
+ * When combined with the max_size_policy, errors still take up space in the cache,
+ * but no more than \p max_errors of it.
+ * So a burst of errors for distinct keys can't push out all the values.
+ *
+ * This policy enables the negative_cache_policy.
+ * \ingroup libhoard_api
+ */
+class error_max_size_policy {
+  private:
+  struct tag;
+
+  public:
+  using dependencies = detail::type_list<negative_cache_policy>;
+  class value_base;
+  template<typename HashTable, typename ValueType, typename Allocator> class table_base;
+
+  /**
+   * \brief Create an error size limit.
+   * \param max_errors The maximum number of errors in the cache.
+   */
+  explicit error_max_size_policy(std::size_t max_errors) noexcept;
+
+  private:
+  std::size_t max_errors;
+};
+
+class error_max_size_policy::value_base
+: public detail::linked_list_link<tag>
+{
+  public:
+  template<typename HashTable>
+  explicit value_base(const HashTable& table) noexcept;
+};
+
+template<typename HashTable, typename ValueType, typename Allocator>
+class error_max_size_policy::table_base {
+  public:
+  table_base(const error_max_size_policy& policy, const Allocator& allocator) noexcept;
+
+  auto on_assign_(ValueType* vptr, bool value, bool assigned_via_callback) noexcept -> void;
+  auto on_hit_(ValueType* vptr) noexcept -> void;
+  auto on_unlink_(ValueType* vptr) noexcept -> void;
+
+  ///\brief Number of errors tracked by this policy.
+  auto error_count() const noexcept -> std::size_t;
+
+  private:
+  auto unlink_(ValueType* vptr) noexcept -> void;
+
+  std::size_t max_errors_;
+  std::size_t count_ = 0;
+  detail::linked_list<ValueType, tag> errors_;
+};
+
+
+} /* namespace libhoard */
+
+#include "error_max_size_policy.ii"
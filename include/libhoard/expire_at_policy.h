@@ -24,6 +24,8 @@ class expire_at_policy<Clock>::value_base {
 
   auto expired() const noexcept -> bool;
   auto expire_at(typename Clock::time_point expire_tp) noexcept -> void;
+  ///\brief The time at which the value expires, or `time_point::max()` if it doesn't.
+  auto expire_tp() const noexcept -> typename Clock::time_point;
 
   private:
   typename Clock::time_point expire_tp_ = Clock::time_point::max();
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "snapshot_codec.h"
+#include "detail/function_ref.h"
+
+namespace libhoard {
+
+
+/**
+ * \brief Disk-backed key-value store, for use as the second tier of a cache.
+ * \details
+ * Values are encoded and appended to a file.
+ * The store keeps an in-memory index of the keys, together with the location of their value in the file.
+ * Reading a value back costs a single `pread`.
+ *
+ * The file is private to the store: it is truncated when the store is opened,
+ * and unlinked immediately, so its disk space is released when the store is destroyed,
+ * even if the process crashes.
+ *
+ * Removed values leave a hole in the file.
+ * Once the holes outweigh the live data, the file is compacted in place.
+ *
+ * The store is not thread safe.
+ * The tiered_policy guards it with a lock of its own.
+ *
+ * \note This requires a POSIX system.
+ * \tparam KeyType The key type of the store. Keys are kept in memory.
+ * \tparam T The mapped type of the store. Mapped values are kept on disk.
+ * \tparam MappedCodec Codec used to translate mapped values to and from bytes.
+ */
+template<typename KeyType, typename T, typename MappedCodec = snapshot_codec<T>>
+class file_store {
+  public:
+  using key_type = KeyType;
+  using mapped_type = T;
+
+  ///\brief Default threshold at which the file is considered for compaction.
+  static constexpr std::uint64_t default_compaction_threshold = 1024u * 1024u;
+
+  private:
+  struct record {
+    key_type key;
+    std::uint64_t offset;
+    std::uint64_t size;
+  };
+
+  using index_type = std::unordered_multimap<std::size_t, record>;
+
+  public:
+  /**
+   * \brief Create a store using the file at \p path.
+   * \param path The file to use. Any existing file at this path is replaced.
+   * \param compaction_threshold The file won't be compacted while it wastes fewer bytes than this.
+   * \throw std::system_error if the file can't be created.
+   */
+  explicit file_store(const std::string& path, std::uint64_t compaction_threshold = default_compaction_threshold);
+  file_store(const file_store&) = delete;
+  file_store(file_store&& y) noexcept;
+  auto operator=(const file_store&) -> file_store& = delete;
+  auto operator=(file_store&& y) noexcept -> file_store&;
+  ~file_store() noexcept;
+
+  /**
+   * \brief Add a value to the store.
+   * \details
+   * The caller must ensure the key isn't already present in the store.
+   * \param hash The hash code of the key.
+   * \param key The key of the value.
+   * \param value The value to store.
+   * \throw std::system_error if the value can't be written.
+   */
+  auto put(std::size_t hash, const key_type& key, const mapped_type& value) -> void;
+
+  /**
+   * \brief Remove a value from the store, and return it.
+   * \param hash The hash code of the key.
+   * \param matcher Predicate selecting the key.
+   * \return The value that was removed, or an empty optional if the key isn't present.
+   * \throw std::system_error if the value can't be read.
+   */
+  auto take(std::size_t hash, detail::function_ref<bool(const key_type&)> matcher) -> std::optional<mapped_type>;
+
+  ///\brief Remove the values matching a key.
+  auto erase(std::size_t hash, detail::function_ref<bool(const key_type&)> matcher) -> void;
+  ///\brief Remove all values.
+  auto clear() noexcept -> void;
+
+  ///\brief Number of values in the store.
+  auto size() const noexcept -> std::size_t;
+  ///\brief Test if the store holds no values.
+  auto empty() const noexcept -> bool;
+  ///\brief Number of bytes used by the file.
+  auto file_size() const noexcept -> std::uint64_t;
+
+  private:
+  auto remove_(typename index_type::iterator iter) noexcept -> void;
+  auto maybe_compact_() -> void;
+  auto read_(std::uint64_t offset, std::uint64_t size) const -> std::string;
+  auto write_(std::uint64_t offset, const char* data, std::uint64_t size) -> void;
+
+  int fd_ = -1;
+  std::uint64_t end_ = 0; // Offset at which the next value is written.
+  std::uint64_t live_bytes_ = 0;
+  std::uint64_t compaction_threshold_;
+  index_type index_;
+};
+
+
+} /* namespace libhoard */
+
+#include "file_store.ii"
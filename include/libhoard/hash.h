@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
 #include <utility>
 
 namespace libhoard {
@@ -47,4 +51,25 @@ class hash {
 };
 
 
+/**
+ * \brief Transparent hash function for strings.
+ * \details
+ * Hashes anything that converts to a string view, such as string literals and string views.
+ * Because it is transparent, lookups don't need to construct a string.
+ *
+ * Produces the same hash codes as `std::hash<std::basic_string<CharT, Traits>>`.
+ *
+ * This is the default hash function for caches with a `std::basic_string` key.
+ * \ingroup libhoard_api
+ */
+template<typename CharT, typename Traits = std::char_traits<CharT>>
+struct transparent_string_hash {
+  using is_transparent = void;
+
+  auto operator()(std::basic_string_view<CharT, Traits> s) const noexcept -> std::size_t {
+    return std::hash<std::basic_string_view<CharT, Traits>>()(s);
+  }
+};
+
+
 } /* namespace libhoard */
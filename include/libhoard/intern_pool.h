@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "detail/basic_hashtable.h"
+
+namespace libhoard {
+
+
+/**
+ * \brief Deduplicates strings.
+ * \details
+ * Interning a string returns a handle to the one copy of that string held by the pool.
+ * Interning an equal string later returns a handle to the same copy.
+ *
+ * Each string is stored once, in a single allocation holding the hash code,
+ * a reference counter and the (null-terminated) characters.
+ * The allocation is linked directly into the hashtable of the pool,
+ * so there is no separate key, node or control block.
+ *
+ * Looking up a string that is already interned doesn't allocate.
+ * A string is released when the last handle to it is destroyed.
+ * Handles may outlive the pool.
+ *
+ * The pool is thread safe.
+ * Copying and destroying handles doesn't take the lock of the pool,
+ * except when the last handle of a string is destroyed.
+ *
+ * This replaces the cache of `std::shared_ptr<const std::string>`, that uses the weaken_policy to intern strings.
+ * \tparam CharT The character type of the strings.
+ * \tparam Traits The character traits of the strings.
+ * \tparam Allocator Allocator used to allocate strings.
+ * \ingroup libhoard_api
+ */
+template<typename CharT, typename Traits = std::char_traits<CharT>, typename Allocator = std::allocator<CharT>>
+class intern_pool {
+  public:
+  using string_view_type = std::basic_string_view<CharT, Traits>;
+  using allocator_type = Allocator;
+  class handle;
+
+  private:
+  class entry;
+  class core;
+
+  public:
+  explicit intern_pool(const allocator_type& alloc = allocator_type());
+  intern_pool(const intern_pool&) = delete;
+  auto operator=(const intern_pool&) -> intern_pool& = delete;
+  ~intern_pool() noexcept;
+
+  /**
+   * \brief Intern a string.
+   * \details
+   * If the pool holds the string, this returns a handle to it, without allocating memory.
+   * Otherwise, a copy of \p s is added to the pool.
+   * \return Handle to the interned copy of \p s.
+   */
+  auto intern(string_view_type s) -> handle;
+  /**
+   * \brief Look up a string, without interning it.
+   * \return Handle to the interned copy of \p s, or an empty handle if \p s isn't interned.
+   */
+  auto find(string_view_type s) const -> handle;
+  ///\brief Number of distinct strings in the pool.
+  auto size() const -> std::size_t;
+
+  private:
+  core* core_;
+};
+
+
+/**
+ * \brief Handle to an interned string.
+ * \details
+ * The handle is the size of a pointer.
+ * Handles from the same pool compare equal if they refer to equal strings.
+ */
+template<typename CharT, typename Traits, typename Allocator>
+class intern_pool<CharT, Traits, Allocator>::handle {
+  friend intern_pool;
+
+  public:
+  ///\brief Create an empty handle.
+  handle() noexcept = default;
+  handle(const handle& y) noexcept;
+  handle(handle&& y) noexcept;
+  auto operator=(const handle& y) noexcept -> handle&;
+  auto operator=(handle&& y) noexcept -> handle&;
+  ~handle() noexcept;
+
+  private:
+  explicit handle(entry* e) noexcept;
+
+  public:
+  ///\brief Test if the handle refers to a string.
+  explicit operator bool() const noexcept;
+  ///\brief The interned string. Empty if the handle is empty.
+  auto view() const noexcept -> string_view_type;
+  operator string_view_type() const noexcept;
+  ///\brief The null-terminated characters of the string. Null if the handle is empty.
+  auto c_str() const noexcept -> const CharT*;
+  ///\brief The length of the string.
+  auto size() const noexcept -> std::size_t;
+  ///\brief The hash code of the string, as computed by `std::hash<string_view_type>`.
+  auto hash() const noexcept -> std::size_t;
+
+  auto operator==(const handle& y) const noexcept -> bool;
+  auto operator!=(const handle& y) const noexcept -> bool;
+
+  private:
+  auto release_() noexcept -> void;
+
+  entry* e_ = nullptr;
+};
+
+
+} /* namespace libhoard */
+
+#include "intern_pool.ii"
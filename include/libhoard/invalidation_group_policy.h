@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+#include "detail/cache_async_get.h"
+#include "detail/linked_list.h"
+#include "detail/refcount.h"
+
+namespace libhoard {
+
+
+/**
+ * \brief Policy that groups elements by tag, so that a group can be invalidated in one go.
+ * \details
+ * When an element is created, the tag function is invoked with its key.
+ * It returns the tag of the element, or a range of tags if the element is in multiple groups.
+ *
+ * Each group keeps an intrusive list of its elements.
+ * `cache.invalidate_group(tag)` expires exactly the elements in the group,
+ * in time proportional to the size of the group, without scanning the rest of the cache.
+ * Invalidating a group is equivalent to erasing the key of each element in the group:
+ * pending lookups are cancelled, so new lookups won't join them.
+ *
+ * Empty groups are discarded.
+ *
+ * Example: invalidate all elements of a tenant.
+ * \code
+ * struct tenant_of {
+ *   auto operator()(const std::pair<tenant_id, std::string>& key) const -> tenant_id { return key.first; }
+ * };
+ *
+ * libhoard::cache<std::pair<tenant_id, std::string>, config_value,
+ *     libhoard::invalidation_group_policy<tenant_id, tenant_of>> c;
+ * c.invalidate_group(tenant);
+ * \endcode
+ *
+ * \tparam Tag The type of group tags. Must be hashable using `std::hash`.
+ * \tparam TagFn Function that computes the tags of a key.
+ * \ingroup libhoard_api
+ */
+template<typename Tag, typename TagFn>
+class invalidation_group_policy {
+  private:
+  struct group_link_tag;
+  struct element_link_tag;
+  struct group;
+  struct membership;
+
+  public:
+  using tag_type = Tag;
+  class value_base;
+  template<typename HashTable, typename ValueType, typename Allocator> class table_base;
+  template<typename Impl, typename HashTableType>
+  using add_cache_base = detail::cache_base<invalidation_group_policy, Impl, HashTableType>;
+
+  explicit invalidation_group_policy(TagFn tag_fn = TagFn());
+
+  private:
+  TagFn tag_fn_;
+};
+
+///\brief Membership of an element in a group.
+template<typename Tag, typename TagFn>
+struct invalidation_group_policy<Tag, TagFn>::membership
+: detail::linked_list_link<group_link_tag>,
+  detail::linked_list_link<element_link_tag>
+{
+  membership(value_base* owner, group* g) noexcept
+  : owner(owner),
+    g(g)
+  {}
+
+  value_base*const owner;
+  group*const g;
+};
+
+///\brief Group of elements.
+template<typename Tag, typename TagFn>
+struct invalidation_group_policy<Tag, TagFn>::group {
+  detail::linked_list<membership, group_link_tag> members;
+  const Tag* tag = nullptr; // Points at the key of the group in the table.
+};
+
+template<typename Tag, typename TagFn>
+class invalidation_group_policy<Tag, TagFn>::value_base {
+  template<typename HashTable, typename ValueType, typename Allocator> friend class invalidation_group_policy::table_base;
+
+  public:
+  template<typename HashTable>
+  explicit value_base(const HashTable& table) noexcept;
+
+  private:
+  detail::linked_list<membership, element_link_tag> memberships_;
+};
+
+template<typename Tag, typename TagFn>
+template<typename HashTable, typename ValueType, typename Allocator>
+class invalidation_group_policy<Tag, TagFn>::table_base {
+  private:
+  using membership_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<membership>;
+  using groups_map = std::unordered_map<
+      Tag, group, std::hash<Tag>, std::equal_to<Tag>,
+      typename std::allocator_traits<Allocator>::template rebind_alloc<std::pair<const Tag, group>>>;
+
+  public:
+  table_base(const invalidation_group_policy& policy, const Allocator& allocator);
+
+  ///\brief Add the element to the groups of its key.
+  auto on_create_(ValueType* vptr) noexcept -> void;
+  ///\brief Remove the element from its groups.
+  auto on_unlink_(ValueType* vptr) noexcept -> void;
+
+  ///\brief Expire all elements in the group \p tag.
+  auto invalidate_group(const Tag& tag) -> void;
+
+  private:
+  ///\brief Add the element to the group \p tag.
+  auto join_(ValueType* vptr, const Tag& tag) -> void;
+
+  TagFn tag_fn_;
+  membership_allocator alloc_;
+  groups_map groups_;
+};
+
+
+} /* namespace libhoard */
+
+namespace libhoard::detail {
+
+
+template<typename Tag, typename TagFn, typename Impl, typename HashTableType>
+class cache_base<invalidation_group_policy<Tag, TagFn>, Impl, HashTableType> {
+  protected:
+  cache_base() noexcept = default;
+  cache_base(const cache_base&) noexcept = default;
+  cache_base(cache_base&&) noexcept = default;
+  ~cache_base() noexcept = default;
+  auto operator=(const cache_base&) noexcept -> cache_base& = default;
+  auto operator=(cache_base&&) noexcept -> cache_base& = default;
+
+  public:
+  ///\brief Expire all elements in the group \p tag.
+  auto invalidate_group(const Tag& tag) -> void;
+};
+
+
+} /* namespace libhoard::detail */
+
+#include "invalidation_group_policy.ii"
@@ -10,6 +10,8 @@ namespace libhoard {
 
 /**
  * \brief Policy that restricts the number of elements in the cache.
+ * \details
+ * If the cache has the weaken_policy, weakened elements don't count towards the size.
  */
 class max_size_policy {
   public:
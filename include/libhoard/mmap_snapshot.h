@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "snapshot_codec.h"
+
+namespace libhoard {
+
+
+/**
+ * \brief Read-only, memory-mapped key-value file.
+ * \details
+ * The file holds an open-addressing index followed by a blob of keys and values.
+ * It is created using the write() function, from a range of key-value pairs.
+ *
+ * Opening the snapshot only maps the file; nothing is read or allocated up front.
+ * The kernel loads pages lazily, as lookups touch them.
+ *
+ * The index uses its own hash function over the encoded key bytes,
+ * so the file remains valid across processes and builds.
+ * The file is stored in native byte order.
+ *
+ * \note This requires a POSIX system.
+ * \tparam KeyType The key type of the snapshot.
+ * \tparam T The mapped type of the snapshot.
+ * \tparam KeyCodec Codec used to translate keys to bytes.
+ * \tparam MappedCodec Codec used to translate mapped values to and from bytes.
+ */
+template<typename KeyType, typename T, typename KeyCodec = snapshot_codec<KeyType>, typename MappedCodec = snapshot_codec<T>>
+class mmap_snapshot {
+  public:
+  using key_type = KeyType;
+  using mapped_type = T;
+
+  private:
+  struct header;
+  struct slot;
+
+  public:
+  ///\brief Open the snapshot at \p path.
+  ///\throw std::system_error if the file can't be opened or mapped.
+  ///\throw std::runtime_error if the file isn't a valid snapshot.
+  explicit mmap_snapshot(const std::string& path);
+  mmap_snapshot(const mmap_snapshot&) = delete;
+  mmap_snapshot(mmap_snapshot&& y) noexcept;
+  auto operator=(const mmap_snapshot&) -> mmap_snapshot& = delete;
+  auto operator=(mmap_snapshot&& y) noexcept -> mmap_snapshot&;
+  ~mmap_snapshot() noexcept;
+
+  ///\brief Look up the mapped value for \p key.
+  ///\return A copy of the mapped value, or an empty optional if the key isn't present.
+  template<typename Key>
+  auto lookup(const Key& key) const -> std::optional<mapped_type>;
+  ///\brief Look up the encoded bytes of the mapped value for \p key.
+  ///\return A view into the mapped file, valid for as long as the snapshot is open.
+  template<typename Key>
+  auto lookup_view(const Key& key) const -> std::optional<std::string_view>;
+
+  ///\brief Number of entries in the snapshot.
+  auto size() const noexcept -> std::size_t;
+  ///\brief Test if the snapshot holds no entries.
+  auto empty() const noexcept -> bool;
+
+  /**
+   * \brief Write a snapshot file.
+   * \details
+   * The range must not contain duplicate keys.
+   * \param path The file to write.
+   * \param b,e Range of key-value pairs.
+   */
+  template<typename Iter>
+  static auto write(const std::string& path, Iter b, Iter e) -> void;
+
+  private:
+  static auto hash_(std::string_view bytes) noexcept -> std::uint64_t;
+  auto header_() const noexcept -> const header&;
+  auto slots_() const noexcept -> const slot*;
+  auto blob_() const noexcept -> std::string_view;
+  auto validate_() const -> void;
+
+  const unsigned char* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+
+} /* namespace libhoard */
+
+#include "mmap_snapshot.ii"
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace libhoard {
+
+
+/**
+ * \brief Mutex that busy-waits until the lock is available.
+ * \details
+ * Waiting threads spin on a plain load of the lock state,
+ * so they don't bounce the cache line between cores while the lock is held.
+ * After a while, waiting threads start yielding their time slice.
+ *
+ * Spinning suits the short critical sections of cache hits,
+ * but wastes CPU time if the lock is held for long,
+ * for example by a synchronous resolver.
+ *
+ * Use with `basic_thread_safe_policy<spin_mutex>`.
+ * \ingroup libhoard_api
+ */
+class spin_mutex {
+  public:
+  ///\brief Number of spins, after which waiting threads start yielding.
+  static inline constexpr unsigned int yield_after = 64;
+
+  spin_mutex() noexcept = default;
+  spin_mutex(const spin_mutex&) = delete;
+  auto operator=(const spin_mutex&) -> spin_mutex& = delete;
+
+  auto lock() noexcept -> void;
+  auto try_lock() noexcept -> bool;
+  auto unlock() noexcept -> void;
+
+  private:
+  std::atomic<bool> locked_{ false };
+};
+
+
+/**
+ * \brief Mutex that spins for a short while, and then sleeps until the lock is released.
+ * \details
+ * Uncontended and briefly contended locks are handled entirely in user space.
+ * If the lock isn't released within \ref spin_count spins, the waiting thread sleeps on a futex.
+ * Unlocking only makes a system call if there may be sleeping threads.
+ *
+ * On platforms without futexes, waiting threads yield instead of sleeping.
+ *
+ * Use with `basic_thread_safe_policy<adaptive_mutex>`.
+ * \ingroup libhoard_api
+ */
+class adaptive_mutex {
+  public:
+  ///\brief Number of spins before a waiting thread goes to sleep.
+  static inline constexpr unsigned int spin_count = 100;
+
+  adaptive_mutex() noexcept = default;
+  adaptive_mutex(const adaptive_mutex&) = delete;
+  auto operator=(const adaptive_mutex&) -> adaptive_mutex& = delete;
+
+  auto lock() noexcept -> void;
+  auto try_lock() noexcept -> bool;
+  auto unlock() noexcept -> void;
+
+  private:
+  auto lock_slow_() noexcept -> void;
+
+  static inline constexpr std::uint32_t unlocked = 0;
+  static inline constexpr std::uint32_t locked = 1;
+  static inline constexpr std::uint32_t contended = 2; // Locked, and there may be sleeping threads.
+
+  std::atomic<std::uint32_t> state_{ unlocked };
+};
+
+
+} /* namespace libhoard */
+
+#include "mutex.ii"
@@ -20,7 +20,6 @@ class negative_cache_policy {
   };
 
   public:
-  template<typename Table>
   using value_base = value_base_impl;
 };
 
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <condition_variable>
+#include <random>
+#include <thread>
+
+#include "expire_at_policy.h"
+#include "thread_safe_policy.h"
+#include "detail/linked_list.h"
+#include "detail/meta.h"
+#include "detail/refresh_impl_policy.h"
+
+namespace libhoard {
+
+
+/**
+ * \brief Policy that refreshes values that are read close to their expiry.
+ * \details
+ * Each time a value is looked up, the policy decides whether to refresh it early,
+ * using the probabilistic early expiration algorithm (XFetch).
+ * The value is refreshed if
+ * \code
+ * now - delta * beta * log(random()) >= expiry
+ * \endcode
+ * where `random()` is uniformly distributed in (0, 1].
+ * The probability of a refresh thus rises as the value approaches its expiry.
+ *
+ * Unlike the refresh_policy, values that aren't read are never refreshed:
+ * they simply expire.
+ * The refresh load is proportional to the read traffic.
+ *
+ * The expiry is taken from the expire_at_policy, so this policy should be
+ * combined with a policy that sets it, such as the max_age_policy using the same clock.
+ *
+ * Refreshes are performed in the background, by a worker thread.
+ * Until the refresh completes, lookups keep returning the current value.
+ * \tparam Clock The clock of the expire_at_policy that holds the expiry.
+ * \ingroup libhoard_api
+ */
+template<typename Clock>
+class refresh_ahead_policy {
+  private:
+  struct tag;
+
+  public:
+  using dependencies = detail::type_list<detail::refresh_impl_policy, expire_at_policy<Clock>, thread_safe_policy>;
+  class value_base;
+  template<typename HashTable, typename ValueType, typename Allocator> class table_base;
+
+  /**
+   * \brief Create a refresh-ahead policy.
+   * \param delta The expected time it takes to resolve a value.
+   * \param beta Scaling factor. Values above 1 favour earlier refreshes, values below 1 favour later refreshes.
+   */
+  explicit refresh_ahead_policy(typename Clock::duration delta, double beta = 1.0);
+
+  private:
+  typename Clock::duration delta;
+  double beta;
+};
+
+template<typename Clock>
+class refresh_ahead_policy<Clock>::value_base
+: public detail::linked_list_link<tag>
+{
+  public:
+  template<typename HashTable>
+  explicit value_base(const HashTable& table);
+};
+
+template<typename Clock>
+template<typename HashTable, typename ValueType, typename Allocator>
+class refresh_ahead_policy<Clock>::table_base {
+  public:
+  table_base(const refresh_ahead_policy& policy, const Allocator& allocator);
+
+  auto on_hit_(ValueType* vptr) noexcept -> void;
+  auto on_unlink_(ValueType* vptr) noexcept -> void;
+  auto init() -> void;
+  auto destroy() -> void;
+
+  private:
+  auto worker_task() -> void;
+
+  double delta_seconds, beta;
+  std::minstd_rand prng;
+  detail::linked_list<ValueType, tag> refresh_queue;
+  bool stop = false;
+  std::thread worker;
+  std::condition_variable_any refresh_queue_changed;
+};
+
+
+} /* namespace libhoard */
+
+#include "refresh_ahead_policy.ii"
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <random>
+
+namespace libhoard {
+
+
+/**
+ * \brief Spreads refreshes out over time.
+ * \details
+ * Values that are loaded at the same time, would otherwise be refreshed at the same time,
+ * every refresh-delay.
+ * Pacing breaks up these refresh storms in two ways:
+ * - jitter randomly shortens the refresh delay of each value by up to a fraction of the delay.
+ *   Over time, this spreads the refreshes evenly.
+ * - a rate limit caps the number of refreshes per second.
+ *   Refreshes that exceed the rate are postponed to the next free slot,
+ *   instead of being dropped.
+ *
+ * The rate limit is a token bucket, holding up to \p burst tokens,
+ * which refills at \p max_rate tokens per second.
+ *
+ * The default constructed pacing applies neither jitter nor a rate limit.
+ * \tparam Clock The clock used for scheduling refreshes.
+ * \ingroup libhoard_api
+ */
+template<typename Clock>
+class refresh_pacing {
+  public:
+  ///\brief Pacing without jitter and without a rate limit.
+  refresh_pacing();
+
+  /**
+   * \brief Create a pacing.
+   * \param jitter Fraction of the delay, by which refreshes may be moved forward. Clamped to the range [0, 1].
+   * \param max_rate Maximum number of refreshes per second. If zero, the rate is unlimited.
+   * \param burst Number of refreshes that may happen at the same time, before the rate limit applies.
+   */
+  explicit refresh_pacing(double jitter, double max_rate = 0.0, unsigned int burst = 1);
+
+  /**
+   * \brief Compute the time at which a value should be refreshed.
+   * \param now The current time.
+   * \param delay The refresh delay.
+   * \return A time point between `now + (1 - jitter) * delay` and `now + delay`.
+   */
+  auto next_refresh(typename Clock::time_point now, typename Clock::duration delay) -> typename Clock::time_point;
+
+  /**
+   * \brief Reserve a slot for a refresh.
+   * \details
+   * The caller must hold off on the refresh until the returned time.
+   * The slot is reserved: the next call will return a later slot, if the rate is exceeded.
+   * \param now The current time.
+   * \return The time at which the refresh may start. This is \p now, unless the rate is exceeded.
+   */
+  auto acquire(typename Clock::time_point now) -> typename Clock::time_point;
+
+  ///\brief True if this pacing has a rate limit.
+  auto rate_limited() const noexcept -> bool;
+
+  private:
+  double jitter_ = 0.0;
+  typename Clock::duration interval_ = Clock::duration::zero(); // Time between two tokens.
+  typename Clock::duration burst_window_ = Clock::duration::zero(); // Time covered by a full bucket, minus one token.
+  typename Clock::time_point tat_; // Theoretical arrival time of the next refresh, if the bucket is empty.
+  std::minstd_rand prng_;
+};
+
+
+} /* namespace libhoard */
+
+#include "refresh_pacing.ii"
@@ -1,38 +1,71 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <memory>
 #include <thread>
 #include <tuple>
+#include <vector>
 
+#include "refresh_pacing.h"
 #include "thread_safe_policy.h"
-#include "detail/linked_list.h"
+#include "detail/indexed_heap.h"
 #include "detail/meta.h"
 #include "detail/refresh_impl_policy.h"
 
 namespace libhoard {
 
 
+/**
+ * \brief Policy that periodically refreshes values in the cache.
+ * \details
+ * Refreshes are performed by a pool of worker threads.
+ * Each worker performs one refresh at a time,
+ * so the number of workers caps the number of refreshes in flight.
+ *
+ * With a synchronous resolver, workers release the cache lock while the resolver runs.
+ * The resolver must therefore be safe to invoke from multiple threads,
+ * if more than one worker is used.
+ *
+ * Refreshes can be spread out using a refresh_pacing.
+ *
+ * Pending refreshes are kept in a heap, ordered by refresh time.
+ * \tparam Clock The clock used to schedule refreshes.
+ */
 template<typename Clock>
 class refresh_policy {
   private:
   struct tag;
+  struct refresh_order;
 
   public:
   using dependencies = detail::type_list<detail::refresh_impl_policy, thread_safe_policy>;
   class value_base;
   template<typename HashTable, typename ValueType, typename Allocator> class table_base;
 
-  explicit refresh_policy(typename Clock::duration delay, typename Clock::duration idle_timer = Clock::duration::zero());
+  /**
+   * \brief Create a refresh policy.
+   * \param delay The time after which a value is refreshed.
+   * \param idle_timer If non-zero, values that aren't looked up for this long, are no longer refreshed.
+   * \param workers The number of worker threads. Must be at least 1.
+   * \param pacing Jitter and rate limit for refreshes.
+   */
+  explicit refresh_policy(typename Clock::duration delay, typename Clock::duration idle_timer = Clock::duration::zero(), std::size_t workers = 1, refresh_pacing<Clock> pacing = refresh_pacing<Clock>());
 
   private:
   typename Clock::duration delay, idle_timer;
+  std::size_t workers;
+  refresh_pacing<Clock> pacing;
 };
 
 template<typename Clock>
 class refresh_policy<Clock>::value_base
-: public detail::linked_list_link<tag>
+: public detail::indexed_heap_link<tag>
 {
   template<typename HashTable, typename ValueType, typename Allocator> friend class refresh_policy::table_base;
+  friend refresh_policy::refresh_order;
 
   public:
   template<typename HashTable>
@@ -43,7 +76,13 @@ class refresh_policy<Clock>::value_base
 
   private:
   typename Clock::time_point refresh_tp;
-  typename Clock::time_point cancel_tp = Clock::time_point::max();
+  std::atomic<typename Clock::time_point> cancel_tp{ Clock::time_point::max() }; // Atomic: the thread_local_front_policy reads it without the lock.
+};
+
+///\brief Orders values by their refresh time.
+template<typename Clock>
+struct refresh_policy<Clock>::refresh_order {
+  auto operator()(const value_base& x, const value_base& y) const noexcept -> bool;
 };
 
 template<typename Clock>
@@ -53,6 +92,8 @@ class refresh_policy<Clock>::table_base {
   table_base(const refresh_policy& policy, const Allocator& allocator);
   table_base(refresh_policy&& policy, const Allocator& allocator);
 
+  auto on_reserve_(ValueType* vptr) -> void;
+  auto on_create_(ValueType* vptr) noexcept -> void;
   auto on_assign_(ValueType* vptr, bool value, bool assigned_via_callback) noexcept -> void;
   auto on_hit_(ValueType* vptr) noexcept -> void;
   auto on_unlink_(ValueType* vptr) noexcept -> void;
@@ -60,12 +101,115 @@ class refresh_policy<Clock>::table_base {
   auto destroy() -> void;
 
   private:
+  auto schedule_(ValueType* vptr, typename Clock::time_point tp) noexcept -> void;
   auto worker_task() -> void;
 
   typename Clock::duration delay, idle_timer;
-  detail::linked_list<ValueType, tag> delay_queue;
+  std::size_t worker_count;
+  refresh_pacing<Clock> pacing;
+  detail::indexed_heap<ValueType, tag, refresh_order, typename std::allocator_traits<Allocator>::template rebind_alloc<ValueType*>> delay_queue;
+  std::size_t linked = 0; // Number of linked elements, the delay_queue has room for all of them.
+  bool stop = false;
+  std::vector<std::thread> workers;
+  std::condition_variable_any delay_queue_changed;
+  ///\brief Wakes workers that wait for a rate limit slot.
+  ///\details Kept apart from delay_queue_changed, so those workers can't swallow a notification meant for an idle worker.
+  std::condition_variable_any stop_changed;
+};
+
+
+/**
+ * \brief Policy that periodically refreshes values in the cache, using a per-value refresh time.
+ * \details
+ * Like the refresh_policy, but the time until the next refresh is computed by a function.
+ * The function is invoked with the mapped type of each value that is loaded,
+ * and returns either a `std::chrono::duration` (the delay until the refresh)
+ * or a `std::chrono::time_point` of \p Clock (the time of the refresh).
+ *
+ * Refreshes are performed by a pool of worker threads.
+ * Pending refreshes are kept in a heap, so scheduling and cancelling a refresh is O(log n).
+ * \tparam Clock The clock used to schedule refreshes.
+ * \tparam RefreshFn Function computing the refresh time of a value.
+ */
+template<typename Clock, typename RefreshFn>
+class refresh_fn_policy {
+  private:
+  struct tag;
+  struct refresh_order;
+
+  public:
+  using dependencies = detail::type_list<detail::refresh_impl_policy, thread_safe_policy>;
+  class value_base;
+  template<typename HashTable, typename ValueType, typename Allocator> class table_base;
+
+  /**
+   * \brief Create a refresh policy.
+   * \param refresh_fn Function computing the refresh time of a value.
+   * \param idle_timer If non-zero, values that aren't looked up for this long, are no longer refreshed.
+   * \param workers The number of worker threads. Must be at least 1.
+   */
+  explicit refresh_fn_policy(RefreshFn refresh_fn, typename Clock::duration idle_timer = Clock::duration::zero(), std::size_t workers = 1);
+
+  private:
+  RefreshFn refresh_fn;
+  typename Clock::duration idle_timer;
+  std::size_t workers;
+};
+
+template<typename Clock, typename RefreshFn>
+class refresh_fn_policy<Clock, RefreshFn>::value_base
+: public detail::indexed_heap_link<tag>
+{
+  template<typename HashTable, typename ValueType, typename Allocator> friend class refresh_fn_policy::table_base;
+  friend refresh_fn_policy::refresh_order;
+
+  public:
+  template<typename HashTable>
+  explicit value_base(const HashTable& table);
+
+  auto expired() const noexcept -> bool;
+  auto on_refresh(const value_base* old_value) noexcept -> void;
+
+  private:
+  typename Clock::time_point refresh_tp;
+  std::atomic<typename Clock::time_point> cancel_tp{ Clock::time_point::max() }; // Atomic: the thread_local_front_policy reads it without the lock.
+};
+
+///\brief Orders values by their refresh time.
+template<typename Clock, typename RefreshFn>
+struct refresh_fn_policy<Clock, RefreshFn>::refresh_order {
+  auto operator()(const value_base& x, const value_base& y) const noexcept -> bool;
+};
+
+template<typename Clock, typename RefreshFn>
+template<typename HashTable, typename ValueType, typename Allocator>
+class refresh_fn_policy<Clock, RefreshFn>::table_base {
+  public:
+  table_base(const refresh_fn_policy& policy, const Allocator& allocator);
+  table_base(refresh_fn_policy&& policy, const Allocator& allocator);
+
+  auto on_reserve_(ValueType* vptr) -> void;
+  auto on_create_(ValueType* vptr) noexcept -> void;
+  auto on_assign_(ValueType* vptr, bool value, bool assigned_via_callback) noexcept -> void;
+  auto on_hit_(ValueType* vptr) noexcept -> void;
+  auto on_unlink_(ValueType* vptr) noexcept -> void;
+  auto init() -> void;
+  auto destroy() -> void;
+
+  private:
+  template<typename Rep, typename Period>
+  static auto refresh_tp_(std::chrono::duration<Rep, Period> delay) -> typename Clock::time_point;
+  template<typename Duration>
+  static auto refresh_tp_(std::chrono::time_point<Clock, Duration> tp) -> typename Clock::time_point;
+  auto worker_task() -> void;
+
+  RefreshFn refresh_fn;
+  typename Clock::duration idle_timer;
+  std::size_t worker_count;
+  detail::indexed_heap<ValueType, tag, refresh_order, typename std::allocator_traits<Allocator>::template rebind_alloc<ValueType*>> delay_queue;
+  std::size_t linked = 0; // Number of linked elements, the delay_queue has room for all of them.
   bool stop = false;
-  std::thread worker;
+  std::vector<std::thread> workers;
   std::condition_variable_any delay_queue_changed;
 };
 
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <condition_variable>
+#include <system_error>
+#include <thread>
+
+#include "thread_safe_policy.h"
+#include "detail/linked_list.h"
+#include "detail/meta.h"
+
+namespace libhoard {
+
+
+/**
+ * \brief Error reported to lookups whose resolve timed out.
+ * \details
+ * The error code is `std::errc::timed_out`.
+ * \ingroup libhoard_api
+ */
+class resolve_timeout_error
+: public std::system_error
+{
+  public:
+  resolve_timeout_error();
+};
+
+
+/**
+ * \brief Policy that fails resolves that don't complete in time.
+ * \details
+ * If an async resolver doesn't assign a value or error before the timeout,
+ * all lookups waiting for the value fail with a timeout error,
+ * and the pending value is marked expired.
+ * The next lookup for the key starts a fresh resolve.
+ * If the resolver completes after the timeout, its result is discarded.
+ *
+ * With the default error type (`std::exception_ptr`), the error is a resolve_timeout_error.
+ * Other error types must be constructible from a `std::error_code`,
+ * and receive `std::errc::timed_out`.
+ *
+ * Timeouts are tracked by a worker thread.
+ * For caches that use asio, the asio_resolve_timeout_policy uses a timer instead.
+ * \tparam Clock The clock used to measure the timeout.
+ * \ingroup libhoard_api
+ */
+template<typename Clock>
+class resolve_timeout_policy {
+  private:
+  struct tag;
+
+  public:
+  using dependencies = detail::type_list<thread_safe_policy>;
+  class value_base;
+  template<typename HashTable, typename ValueType, typename Allocator> class table_base;
+
+  ///\brief Create a policy that fails resolves taking longer than \p timeout.
+  explicit resolve_timeout_policy(typename Clock::duration timeout);
+
+  private:
+  typename Clock::duration timeout;
+};
+
+template<typename Clock>
+class resolve_timeout_policy<Clock>::value_base
+: public detail::linked_list_link<tag>
+{
+  template<typename HashTable, typename ValueType, typename Allocator> friend class resolve_timeout_policy::table_base;
+
+  public:
+  template<typename HashTable>
+  explicit value_base(const HashTable& table);
+
+  private:
+  typename Clock::time_point deadline;
+};
+
+template<typename Clock>
+template<typename HashTable, typename ValueType, typename Allocator>
+class resolve_timeout_policy<Clock>::table_base {
+  public:
+  table_base(const resolve_timeout_policy& policy, const Allocator& allocator);
+
+  auto on_create_(ValueType* vptr) noexcept -> void;
+  auto on_assign_(ValueType* vptr, bool value, bool assigned_via_callback) noexcept -> void;
+  auto on_unlink_(ValueType* vptr) noexcept -> void;
+  auto init() -> void;
+  auto destroy() -> void;
+
+  private:
+  auto worker_task() -> void;
+
+  typename Clock::duration timeout;
+  detail::linked_list<ValueType, tag> deadline_queue; // All values use the same timeout, so the queue is ordered by deadline.
+  bool stop = false;
+  std::thread worker;
+  std::condition_variable_any deadline_queue_changed;
+};
+
+
+} /* namespace libhoard */
+
+namespace libhoard::detail {
+
+
+/**
+ * \brief Fail a pending value, because its resolve timed out.
+ * \details
+ * The callbacks waiting for the value are invoked with a timeout error,
+ * and the value is marked expired, so a later lookup starts a new resolve.
+ *
+ * Policies see this as the resolve completing with an error.
+ * \param self The hashtable. Must be locked.
+ * \param vptr The value that timed out. If it is no longer pending, this function does nothing.
+ */
+template<typename HashTable, typename ValueType>
+auto fail_resolve_timeout(HashTable& self, ValueType* vptr) noexcept -> void;
+
+
+} /* namespace libhoard::detail */
+
+#include "resolve_timeout_policy.ii"
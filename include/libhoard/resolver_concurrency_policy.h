@@ -0,0 +1,154 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+
+#include "detail/cache_async_get.h"
+#include "detail/refcount.h"
+
+namespace libhoard {
+
+
+/**
+ * \brief Counters of the resolver_concurrency_policy.
+ * \ingroup libhoard_api
+ */
+struct resolver_concurrency_stats {
+  ///\brief Number of resolves that are currently running.
+  std::size_t in_flight = 0;
+  ///\brief Number of resolves waiting for a free slot.
+  std::size_t queued = 0;
+  ///\brief How long the oldest queued resolve has been waiting.
+  std::chrono::steady_clock::duration oldest_wait = std::chrono::steady_clock::duration::zero();
+  ///\brief Number of resolves that had to wait for a free slot, since the cache was created.
+  std::uint64_t delayed = 0;
+  ///\brief Total time that resolves spent waiting for a free slot, since the cache was created.
+  std::chrono::steady_clock::duration total_wait = std::chrono::steady_clock::duration::zero();
+};
+
+
+/**
+ * \brief Policy that limits the number of concurrent asynchronous resolves.
+ * \details
+ * When a cache is cold, or after it is cleared, every lookup of a distinct key starts a resolve.
+ * This policy caps the number of resolves that run at the same time.
+ * Excess resolves are queued, and started in FIFO order as running resolves complete.
+ *
+ * A resolve completes when its callback assigns a value or an error.
+ * If a pending value is removed from the cache before its resolve completes,
+ * its slot is released as well.
+ * The queued resolves that can then start, are started by the next lookup or emplace.
+ * Queued resolves for values that were erased in the meantime, are dropped.
+ *
+ * The policy works with the async_resolver_policy and the asio_resolver_policy.
+ * It has no effect on synchronous resolvers.
+ *
+ * Use `cache.resolver_concurrency_stats()` to observe the queue.
+ * \ingroup libhoard_api
+ */
+class resolver_concurrency_policy {
+  private:
+  struct tag;
+
+  public:
+  class value_base;
+  template<typename HashTable, typename ValueType, typename Allocator> class table_base;
+  template<typename Impl, typename HashTableType>
+  using add_cache_base = detail::cache_base<resolver_concurrency_policy, Impl, HashTableType>;
+
+  /**
+   * \brief Create a concurrency limit for resolvers.
+   * \param max_in_flight The maximum number of resolves that may run at the same time. Must be at least 1.
+   */
+  explicit resolver_concurrency_policy(std::size_t max_in_flight);
+
+  private:
+  std::size_t max_in_flight;
+};
+
+class resolver_concurrency_policy::value_base {
+  template<typename HashTable, typename ValueType, typename Allocator> friend class resolver_concurrency_policy::table_base;
+
+  public:
+  template<typename HashTable>
+  explicit value_base(const HashTable& table) noexcept;
+
+  private:
+  bool in_flight_ = false;
+};
+
+template<typename HashTable, typename ValueType, typename Allocator>
+class resolver_concurrency_policy::table_base {
+  private:
+  using clock = std::chrono::steady_clock;
+
+  struct queued_resolve {
+    detail::refcount_ptr<ValueType, Allocator> vptr;
+    std::function<void()> start;
+    clock::time_point enqueued;
+  };
+
+  public:
+  table_base(const resolver_concurrency_policy& policy, const Allocator& allocator);
+
+  auto on_assign_(ValueType* vptr, bool value, bool assigned_via_callback) noexcept -> void;
+  auto on_unlink_(ValueType* vptr) noexcept -> void;
+  auto on_maintenance_() noexcept -> void;
+
+  /**
+   * \brief Start the resolver for \p vptr, or queue it if too many resolves are running.
+   * \details
+   * Invoked by the async resolver policies.
+   */
+  template<typename Fn>
+  auto start_resolve_(ValueType* vptr, Fn&& fn) -> void;
+
+  ///\brief Retrieve the queue counters.
+  auto resolver_concurrency_stats() const -> libhoard::resolver_concurrency_stats;
+
+  private:
+  ///\brief Free the slot held by \p vptr, if it holds one.
+  ///\return True if a slot was freed.
+  auto free_slot_(ValueType* vptr) noexcept -> bool;
+  ///\brief Release the slot held by \p vptr, if it holds one, and start queued resolves.
+  auto release_(ValueType* vptr) noexcept -> void;
+  ///\brief Start queued resolves, while slots are available.
+  auto drain_() noexcept -> void;
+
+  std::size_t max_in_flight;
+  std::size_t in_flight = 0;
+  std::deque<queued_resolve, typename std::allocator_traits<Allocator>::template rebind_alloc<queued_resolve>> queue;
+  bool draining = false;
+  std::uint64_t delayed = 0;
+  clock::duration total_wait = clock::duration::zero();
+};
+
+
+} /* namespace libhoard */
+
+namespace libhoard::detail {
+
+
+template<typename Impl, typename HashTableType>
+class cache_base<resolver_concurrency_policy, Impl, HashTableType> {
+  protected:
+  cache_base() noexcept = default;
+  cache_base(const cache_base&) noexcept = default;
+  cache_base(cache_base&&) noexcept = default;
+  ~cache_base() noexcept = default;
+  auto operator=(const cache_base&) noexcept -> cache_base& = default;
+  auto operator=(cache_base&&) noexcept -> cache_base& = default;
+
+  public:
+  ///\brief Retrieve the counters of the resolver concurrency limit.
+  auto resolver_concurrency_stats() const -> libhoard::resolver_concurrency_stats;
+};
+
+
+} /* namespace libhoard::detail */
+
+#include "resolver_concurrency_policy.ii"
@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <memory>
+#include <mutex>
 #include <tuple>
 #include <future>
 #include <variant>
@@ -11,6 +12,7 @@
 #include "detail/refcount.h"
 #include "detail/async_resolver_callback.h"
 #include "detail/cache_async_get.h"
+#include "detail/cache_get.h"
 #include "detail/traits.h"
 
 namespace libhoard {
@@ -40,6 +42,18 @@ class resolver_policy<Functor>::table_base {
   template<typename... Keys>
   auto resolve(std::size_t hash, const Keys&... keys) -> detail::refcount_ptr<ValueType, Allocator>;
 
+  /**
+   * \brief Resolve a value, without holding the lock while the resolver runs.
+   * \details
+   * The lock is released while the resolver is invoked, and reacquired afterwards.
+   * The returned element is not linked into the hashtable.
+   * \param lck The lock on the hashtable. Must be locked.
+   * \param keys The keys to resolve.
+   * \return A new element, holding the resolved value or error.
+   */
+  template<typename... Keys>
+  auto resolve_unlocked(std::unique_lock<HashTable>& lck, const Keys&... keys) -> detail::refcount_ptr<ValueType, Allocator>;
+
   private:
   const Functor resolver_;
 };
@@ -97,6 +111,9 @@ class cache_base<resolver_policy<Functor>, Impl, HashTableType> {
   public:
   template<typename... Keys>
   auto get(const Keys&... keys) -> typename HashTableType::mapped_type;
+  ///\brief Look up or resolve a value, without copying it.
+  template<typename... Keys>
+  auto get_handle(const Keys&... keys) -> typename HashTableType::handle_type;
 };
 
 
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "cache.h"
+
+namespace libhoard {
+
+
+/**
+ * \brief Cache that is split into multiple independently locked shards.
+ * \details
+ * Each key is assigned to one shard, based on its hash code.
+ * Every shard is a complete cache, with its own lock and its own policies.
+ * Threads that access keys in different shards don't contend for the same lock,
+ * so hits scale with the number of shards.
+ *
+ * Because each shard runs its own policies, limits apply per shard.
+ * For example, a `max_size_policy(1000)` on a cache with 8 shards
+ * limits each shard to 1000 elements, for a total of 8000.
+ *
+ * \tparam KeyType The key type of the cache.
+ * \tparam T The mapped type of the cache.
+ * \tparam Policies Policies of each shard.
+ * \ingroup libhoard_api
+ */
+template<typename KeyType, typename T, typename... Policies>
+class sharded_cache {
+  public:
+  ///\brief The type of each shard.
+  using cache_type = cache<KeyType, T, Policies...>;
+  ///\brief Handle to a value in the cache. Dereferences to `const T&`.
+  using handle_type = typename cache_type::handle_type;
+
+  /**
+   * \brief Create a sharded cache.
+   * \details
+   * Each shard is constructed from a copy of \p args.
+   * \param shard_count The number of shards. This is rounded up to a power of two.
+   * \param args Arguments for the constructor of each shard.
+   */
+  template<typename... Args>
+  explicit sharded_cache(std::size_t shard_count, const Args&... args);
+
+  ///\brief Number of shards.
+  auto shard_count() const noexcept -> std::size_t;
+
+  ///\brief Retrieve the shard that holds the given key.
+  template<typename... Keys>
+  auto shard(const Keys&... keys) -> cache_type&;
+  ///\brief Retrieve the shard that holds the given key.
+  template<typename... Keys>
+  auto shard(const Keys&... keys) const -> const cache_type&;
+
+  ///\brief Retrieve a value, if it is present.
+  template<typename... Keys>
+  auto get_if_exists(const Keys&... keys) const;
+  ///\brief Retrieve a value.
+  template<typename... Keys>
+  auto get(const Keys&... keys);
+  ///\brief Look up a value, without copying it.
+  template<typename... Keys>
+  auto get_handle(const Keys&... keys) -> handle_type;
+  ///\brief Retrieve a value asynchronously.
+  template<typename CompletionCallback, typename... Keys>
+  auto async_get(CompletionCallback&& callback, const Keys&... keys) -> void;
+
+  ///\brief Remove a value from the cache.
+  template<typename... Keys>
+  auto erase(const Keys&... keys) noexcept -> void;
+  ///\brief Remove all values from all shards.
+  auto clear() noexcept -> void;
+  ///\brief Remove all values for which the predicate holds, one shard at a time.
+  ///\details See cache::erase_if().
+  template<typename Pred>
+  auto erase_if(Pred&& pred, std::size_t buckets_per_chunk = cache_type::default_buckets_per_chunk) -> std::size_t;
+  ///\brief Invoke a function for each value, one shard at a time.
+  ///\details See cache::for_each().
+  template<typename Fn>
+  auto for_each(Fn&& fn, std::size_t buckets_per_chunk = cache_type::default_buckets_per_chunk) -> void;
+
+  template<typename... Keys, typename... MappedArgs>
+  auto emplace(std::piecewise_construct_t pc, std::tuple<Keys...> keys, std::tuple<MappedArgs...> mapped) -> void;
+  template<typename KeyArg, typename MappedArg>
+  auto emplace(KeyArg&& key, MappedArg&& mapped) -> void;
+
+  template<typename... Keys, typename... MappedArgs>
+  auto get_or_emplace(std::piecewise_construct_t pc, std::tuple<Keys...> keys, std::tuple<MappedArgs...> mapped) -> T;
+  template<typename KeyArg, typename MappedArg>
+  auto get_or_emplace(KeyArg&& key, MappedArg&& mapped) -> T;
+
+  private:
+  template<typename... Keys>
+  auto shard_index_(const Keys&... keys) const -> std::size_t;
+
+  std::vector<cache_type> shards_;
+  std::uint64_t mask_;
+};
+
+
+} /* namespace libhoard */
+
+#include "sharded_cache.ii"
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "snapshot_codec.h"
+
+namespace libhoard {
+
+
+/**
+ * \brief Fixed-capacity cache in shared memory, that is shared between processes.
+ * \details
+ * The cache lives entirely inside a shared memory segment:
+ * the buckets, the nodes, and the encoded keys and values.
+ * Nodes reference each other using offsets from the start of the segment,
+ * so the segment can be mapped at a different address in each process.
+ *
+ * The segment holds a fixed number of equally sized nodes, which are handed out from a free list.
+ * Each node has room for a key and value of up to \p max_entry_size encoded bytes.
+ * Once all nodes are in use, adding an element evicts the least recently used element.
+ *
+ * The segment is either anonymous, and shared with child processes created with `fork()`,
+ * or named, so unrelated processes can open it.
+ *
+ * Access is serialized by a robust, process-shared mutex in the segment.
+ * If a process dies while holding the lock, the next process to acquire it clears the cache,
+ * since the dead process may have left it half-updated.
+ *
+ * Keys and values are copied in and out of the segment using codecs,
+ * so lookups return a copy of the value.
+ *
+ * \note This requires Linux.
+ * \tparam KeyType The key type of the cache.
+ * \tparam T The mapped type of the cache.
+ * \tparam KeyCodec Codec used to translate keys to bytes.
+ * \tparam MappedCodec Codec used to translate mapped values to and from bytes.
+ * \ingroup libhoard_api
+ */
+template<typename KeyType, typename T, typename KeyCodec = snapshot_codec<KeyType>, typename MappedCodec = snapshot_codec<T>>
+class shm_cache {
+  public:
+  using key_type = KeyType;
+  using mapped_type = T;
+
+  private:
+  struct header;
+  struct node;
+  class lock_guard;
+
+  public:
+  /**
+   * \brief Create a cache in an anonymous shared memory segment.
+   * \details
+   * Processes forked after the cache is created share the cache.
+   * \param capacity The maximum number of elements in the cache.
+   * \param max_entry_size The maximum size of an encoded key plus its encoded value.
+   * \throw std::system_error if the segment can't be created.
+   */
+  shm_cache(std::size_t capacity, std::size_t max_entry_size);
+  shm_cache(const shm_cache&) = delete;
+  shm_cache(shm_cache&& y) noexcept;
+  auto operator=(const shm_cache&) -> shm_cache& = delete;
+  auto operator=(shm_cache&& y) noexcept -> shm_cache&;
+  ~shm_cache() noexcept;
+
+  /**
+   * \brief Create a cache in a named shared memory segment.
+   * \details
+   * The segment remains in existence until it is removed using unlink().
+   * \param name The name of the segment, as used by `shm_open`.
+   * \param capacity The maximum number of elements in the cache.
+   * \param max_entry_size The maximum size of an encoded key plus its encoded value.
+   * \throw std::system_error if the segment can't be created, or already exists.
+   */
+  static auto create(const std::string& name, std::size_t capacity, std::size_t max_entry_size) -> shm_cache;
+  /**
+   * \brief Open a cache that was created using create().
+   * \throw std::system_error if the segment can't be opened.
+   * \throw std::runtime_error if the segment doesn't hold a cache.
+   */
+  static auto open(const std::string& name) -> shm_cache;
+  ///\brief Remove the named segment. Processes that have the cache open can keep using it.
+  static auto unlink(const std::string& name) -> void;
+
+  ///\brief Retrieve a value, if it is present.
+  template<typename Key>
+  auto get_if_exists(const Key& key) const -> std::optional<mapped_type>;
+  /**
+   * \brief Add a value to the cache, replacing any value for the same key.
+   * \throw std::length_error if the encoded key and value don't fit in a node.
+   */
+  template<typename Key, typename MappedArg>
+  auto emplace(const Key& key, MappedArg&& mapped) -> void;
+  ///\brief Remove the value for \p key.
+  template<typename Key>
+  auto erase(const Key& key) -> void;
+  ///\brief Remove all values.
+  auto clear() -> void;
+
+  ///\brief Number of elements in the cache.
+  auto size() const -> std::size_t;
+  ///\brief The maximum number of elements in the cache.
+  auto capacity() const noexcept -> std::size_t;
+
+  private:
+  shm_cache() noexcept = default;
+
+  ///\brief Compute the size of a segment.
+  static auto segment_size_(std::uint64_t bucket_count, std::uint64_t capacity, std::uint64_t node_stride) noexcept -> std::uint64_t;
+  ///\brief Map and initialize a newly created segment.
+  auto init_(int fd, std::size_t capacity, std::size_t max_entry_size) -> void;
+  ///\brief Map an existing segment.
+  auto attach_(int fd) -> void;
+
+  auto header_() const noexcept -> header&;
+  auto at_(std::uint64_t offset) const noexcept -> node*;
+  auto offset_of_(const node* n) const noexcept -> std::uint64_t;
+  auto bucket_(std::uint64_t hash) const noexcept -> std::uint64_t&;
+
+  ///\brief Find the node for the key. The lock must be held.
+  auto find_(std::uint64_t hash, std::string_view key_bytes) const noexcept -> node*;
+  ///\brief Unlink the node from its bucket and the LRU list, and return it to the free list. The lock must be held.
+  auto remove_(node* n) const noexcept -> void;
+  ///\brief Mark the node as most recently used. The lock must be held.
+  auto touch_(node* n) const noexcept -> void;
+  ///\brief Unlink the node from the LRU list. The lock must be held.
+  auto lru_unlink_(node* n) const noexcept -> void;
+  ///\brief Link the node at the front of the LRU list. The lock must be held.
+  auto lru_push_front_(node* n) const noexcept -> void;
+  ///\brief Remove all nodes. The lock must be held.
+  auto clear_() const noexcept -> void;
+
+  void* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+
+} /* namespace libhoard */
+
+#include "shm_cache.ii"
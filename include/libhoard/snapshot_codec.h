@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace libhoard {
+
+
+/**
+ * \brief Codec that translates a value to and from its on-disk representation.
+ * \details
+ * Used by the mmap_snapshot and the file_store to store keys and values.
+ *
+ * A codec must provide two static functions:
+ * - `encode(const T& v) -> std::string_view`, which returns the bytes that represent \p v.
+ *   The bytes must remain valid for as long as \p v is valid.
+ * - `decode(std::string_view bytes) -> T`, which reconstructs the value from its bytes.
+ *
+ * The codec is provided for trivially copyable types and for `std::basic_string<char>`.
+ * You can specialize it for your own types.
+ */
+template<typename T, typename = void>
+struct snapshot_codec;
+
+///\brief Codec for trivially copyable types.
+template<typename T>
+struct snapshot_codec<T, std::enable_if_t<std::is_trivially_copyable_v<T>>> {
+  static auto encode(const T& v) noexcept -> std::string_view;
+  static auto decode(std::string_view bytes) noexcept -> T;
+};
+
+///\brief Codec for strings.
+///\details Lookups accept anything that converts to a `std::string_view`.
+template<typename Traits, typename Alloc>
+struct snapshot_codec<std::basic_string<char, Traits, Alloc>> {
+  static auto encode(std::string_view v) noexcept -> std::string_view;
+  static auto decode(std::string_view bytes) -> std::basic_string<char, Traits, Alloc>;
+};
+
+
+} /* namespace libhoard */
+
+#include "snapshot_codec.ii"
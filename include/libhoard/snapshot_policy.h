@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+
+namespace libhoard {
+
+
+/**
+ * \brief Policy that installs a read-only tier behind the cache.
+ * \details
+ * When a lookup misses the cache, the snapshot is consulted before the resolver is invoked.
+ * Values found in the snapshot are returned directly, without being added to the cache.
+ * This means a snapshot hit doesn't allocate a cache element.
+ *
+ * Because the snapshot is read-only, erasing a key from the cache won't remove it from the snapshot.
+ *
+ * The snapshot is usually a mmap_snapshot, but any type with a
+ * `lookup(const Key&) -> std::optional<mapped_type>` member function will do.
+ * Only single-argument lookups are forwarded to the snapshot.
+ *
+ * \tparam Snapshot The type of the read-only tier.
+ */
+template<typename Snapshot>
+class snapshot_policy {
+  public:
+  template<typename HashTable, typename ValueType, typename Allocator> class table_base;
+
+  snapshot_policy() = delete;
+  explicit snapshot_policy(std::shared_ptr<const Snapshot> snapshot) noexcept;
+
+  private:
+  std::shared_ptr<const Snapshot> snapshot_;
+};
+
+template<typename Snapshot>
+template<typename HashTable, typename ValueType, typename Allocator>
+class snapshot_policy<Snapshot>::table_base {
+  public:
+  table_base(const snapshot_policy& policy, const Allocator& alloc) noexcept;
+  table_base(snapshot_policy&& policy, const Allocator& alloc) noexcept;
+
+  template<typename... Keys>
+  auto fallback_get_(std::size_t hash, const Keys&... keys) const -> std::optional<typename ValueType::mapped_type>;
+
+  private:
+  std::shared_ptr<const Snapshot> snapshot_;
+};
+
+
+} /* namespace libhoard */
+
+#include "snapshot_policy.ii"
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <condition_variable>
+#include <thread>
+#include <utility>
+
+#include "thread_safe_policy.h"
+#include "detail/cache_async_get.h"
+#include "detail/linked_list.h"
+#include "detail/meta.h"
+#include "detail/refresh_impl_policy.h"
+
+namespace libhoard {
+
+
+/**
+ * \brief Policy that serves expired values while they are being reloaded.
+ * \details
+ * A value is fresh for \p max_age after it is loaded.
+ * After that, it is stale for another \p grace period:
+ * lookups still return the stale value immediately,
+ * and the first lookup starts a background reload that replaces it.
+ * Only values that are read while stale are reloaded.
+ * Once the grace period passes, the value expires, and lookups wait for the resolver again.
+ *
+ * This policy controls the expiry of values by itself.
+ * It takes the place of the max_age_policy, and shouldn't be combined with it.
+ *
+ * Use `cache.get_with_staleness(key)` to look up a value, and learn if it is stale.
+ *
+ * Reloads are performed by a worker thread.
+ * With a synchronous resolver, the cache lock is released while the resolver runs.
+ * \tparam Clock The clock used to measure the age of values.
+ * \ingroup libhoard_api
+ */
+template<typename Clock>
+class stale_while_revalidate_policy {
+  private:
+  struct tag;
+
+  public:
+  using dependencies = detail::type_list<detail::refresh_impl_policy, thread_safe_policy>;
+  class value_base;
+  template<typename HashTable, typename ValueType, typename Allocator> class table_base;
+  template<typename Impl, typename HashTableType>
+  using add_cache_base = detail::cache_base<stale_while_revalidate_policy, Impl, HashTableType>;
+
+  /**
+   * \brief Create a stale-while-revalidate policy.
+   * \param max_age How long values are fresh.
+   * \param grace How long values are served while stale.
+   */
+  stale_while_revalidate_policy(typename Clock::duration max_age, typename Clock::duration grace);
+
+  private:
+  typename Clock::duration max_age, grace;
+};
+
+template<typename Clock>
+class stale_while_revalidate_policy<Clock>::value_base
+: public detail::linked_list_link<tag>
+{
+  template<typename HashTable, typename ValueType, typename Allocator> friend class stale_while_revalidate_policy::table_base;
+
+  public:
+  template<typename HashTable>
+  explicit value_base(const HashTable& table);
+
+  auto expired() const noexcept -> bool;
+  ///\brief Test if the value is past its max-age.
+  auto stale() const noexcept -> bool;
+
+  private:
+  typename Clock::time_point stale_tp = Clock::time_point::max();
+  typename Clock::time_point expire_tp = Clock::time_point::max();
+};
+
+template<typename Clock>
+template<typename HashTable, typename ValueType, typename Allocator>
+class stale_while_revalidate_policy<Clock>::table_base {
+  public:
+  table_base(const stale_while_revalidate_policy& policy, const Allocator& allocator);
+
+  auto on_assign_(ValueType* vptr, bool value, bool assigned_via_callback) noexcept -> void;
+  auto on_hit_(ValueType* vptr) noexcept -> void;
+  auto on_unlink_(ValueType* vptr) noexcept -> void;
+  auto init() -> void;
+  auto destroy() -> void;
+
+  private:
+  auto worker_task() -> void;
+
+  typename Clock::duration max_age, grace;
+  detail::linked_list<ValueType, tag> reload_queue;
+  bool stop = false;
+  std::thread worker;
+  std::condition_variable_any reload_queue_changed;
+};
+
+
+} /* namespace libhoard */
+
+namespace libhoard::detail {
+
+
+template<typename Clock, typename Impl, typename HashTableType>
+class cache_base<stale_while_revalidate_policy<Clock>, Impl, HashTableType> {
+  protected:
+  cache_base() noexcept = default;
+  cache_base(const cache_base&) noexcept = default;
+  cache_base(cache_base&&) noexcept = default;
+  ~cache_base() noexcept = default;
+  auto operator=(const cache_base&) noexcept -> cache_base& = default;
+  auto operator=(cache_base&&) noexcept -> cache_base& = default;
+
+  public:
+  /**
+   * \brief Look up or resolve a value, and test if it is stale.
+   * \details
+   * Like `get()`, but also reports if the returned value is stale.
+   * The value and its staleness are read under the same lock,
+   * so they always describe the same element.
+   *
+   * Requires a synchronous resolver.
+   * \return The value, and true if it is stale.
+   */
+  template<typename... Keys>
+  auto get_with_staleness(const Keys&... keys) -> std::pair<typename HashTableType::mapped_type, bool>;
+};
+
+
+} /* namespace libhoard::detail */
+
+#include "stale_while_revalidate_policy.ii"
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "shared_from_this_policy.h"
+#include "detail/function_ref.h"
+#include "detail/meta.h"
+#include "detail/refcount.h"
+
+namespace libhoard {
+
+
+/**
+ * \brief Policy that keeps a small, per-thread front cache of recently hit values.
+ * \details
+ * Each thread that reads the cache gets a direct-mapped array of \p n slots,
+ * which remembers the elements it found in the cache.
+ * The `get` and `get_handle` methods consult this array before they take the cache lock.
+ * A hit in the array takes no lock and doesn't write to memory shared with other threads.
+ * (Copying out a handle still increments the reference counter of the element.)
+ *
+ * Slots are validated using a generation counter, which is shared by all threads.
+ * The counter changes when an element is assigned, unlinked or erased,
+ * and every change invalidates the front cache of every thread.
+ * So the policy pays off for keys that are read much more often than the cache is written to.
+ *
+ * Hits in the front cache aren't seen by the other policies.
+ * For instance, they don't refresh the position of the element in the LRU queue of the max_size_policy.
+ *
+ * The front cache holds a reference to the element in each slot,
+ * which keeps the element alive until the slot is reused, or the thread exits.
+ *
+ * Only mapped types that are held by value can be used with this policy,
+ * since the front cache reads them without locking.
+ * For the same reason, it can't be combined with the weaken_policy or the compact_value_policy.
+ * \ingroup libhoard_api
+ */
+class thread_local_front_policy {
+  public:
+  using dependencies = detail::type_list<shared_from_this_policy>;
+  template<typename HashTable, typename ValueType, typename Allocator> class table_base;
+
+  /**
+   * \brief Create a front cache policy.
+   * \param n Number of slots in the front cache of each thread. Rounded up to a power of two.
+   */
+  explicit thread_local_front_policy(std::size_t n = 16) noexcept;
+
+  private:
+  std::size_t n_;
+
+  ///\brief Source of table identifiers, used to find the front cache of a table.
+  static inline std::atomic<std::uint64_t> next_table_id_{ 0 };
+};
+
+template<typename HashTable, typename ValueType, typename Allocator>
+class thread_local_front_policy::table_base {
+  private:
+  using value_pointer = detail::refcount_ptr<ValueType, Allocator>;
+
+  ///\brief Slot in the front cache.
+  ///\details The slot pins its element, since the element is read without holding the lock.
+  struct slot {
+    explicit slot(const Allocator& alloc);
+    slot(const slot& y) noexcept;
+    ~slot() noexcept;
+    auto operator=(const slot&) -> slot& = delete;
+
+    ///\brief Replace the element in the slot.
+    auto assign(value_pointer new_ptr) noexcept -> void;
+
+    std::uint64_t generation = 0; // Zero is never a valid generation.
+    std::size_t hash = 0;
+    value_pointer ptr;
+  };
+
+  ///\brief Front cache of a table, for one thread.
+  struct front {
+    std::uint64_t table_id;
+    std::weak_ptr<const HashTable> owner; // Used to discard fronts of destroyed tables.
+    std::vector<slot> slots;
+  };
+
+  public:
+  table_base(const thread_local_front_policy& policy, const Allocator& allocator);
+
+  auto on_assign_(ValueType* vptr, bool value, bool assigned_via_callback) noexcept -> void;
+  auto on_unlink_(ValueType* vptr) noexcept -> void;
+  auto on_hit_(ValueType* vptr) noexcept -> void;
+  auto on_expire_(std::size_t hash, detail::function_ref<bool(const typename ValueType::key_type&)> matcher) noexcept -> void;
+  auto on_expire_all_() noexcept -> void;
+
+  ///\brief Look up a value in the front cache of this thread. Doesn't require the lock.
+  template<typename... Keys>
+  auto front_get_(const Keys&... keys) const -> std::optional<typename ValueType::mapped_type>;
+  ///\brief Look up an element in the front cache of this thread. Doesn't require the lock.
+  template<typename... Keys>
+  auto front_get_handle_(const Keys&... keys) const -> value_pointer;
+
+  private:
+  ///\brief Invalidate all front caches.
+  auto invalidate_() noexcept -> void;
+  ///\brief Find the slot for the keys, if it holds an element of the current generation.
+  template<typename... Keys>
+  auto find_(std::uint64_t generation, const Keys&... keys) const -> const slot*;
+  ///\brief The front caches of the calling thread.
+  static auto fronts_() noexcept -> std::vector<front>&;
+  ///\brief The front cache of the calling thread, or null if the thread has none.
+  auto my_front_() const noexcept -> front*;
+
+  Allocator alloc_;
+  std::size_t mask_;
+  std::uint64_t table_id_;
+  std::atomic<std::uint64_t> generation_{ 1 };
+};
+
+
+} /* namespace libhoard */
+
+#include "thread_local_front_policy.ii"
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <atomic>
 #include <mutex>
+#include <thread>
 
 namespace libhoard {
 
@@ -10,8 +12,15 @@ namespace libhoard {
  * \details
  * Makes the thread lockable and implements this by forwarding lock/unlock calls
  * to a mutex.
+ *
+ * The cache doesn't lock itself recursively.
+ * But it invokes resolvers and the completion callbacks of async lookups with the lock held.
+ * If any of those call back into the cache, the mutex must be recursive, or the call deadlocks.
+ * \tparam Mutex The mutex type. Must meet the Lockable requirements.
+ * \ingroup libhoard_api
  */
-class thread_safe_policy {
+template<typename Mutex = std::recursive_mutex>
+class basic_thread_safe_policy {
   private:
   ///\brief Policy implementation.
   ///\tparam HashTable The derived hashtable type.
@@ -19,14 +28,26 @@ class thread_safe_policy {
     public:
     ///\brief Constructor.
     template<typename Alloc>
-    table_base_impl(const thread_safe_policy& policy, const Alloc& alloc);
+    table_base_impl(const basic_thread_safe_policy& policy, const Alloc& alloc);
 
     auto lock() -> void;
     auto try_lock() -> bool;
     auto unlock() -> void;
 
+    /**
+     * \brief Test if the calling thread holds the lock.
+     * \details
+     * Async resolvers are invoked with the lock held.
+     * If they complete (or drop) their callback before they return,
+     * the callback uses this to skip locking.
+     */
+    auto owns_lock_() const noexcept -> bool;
+
     private:
-    std::recursive_mutex mtx_;
+    Mutex mtx_;
+    std::atomic<std::thread::id> owner_;
+    ///\brief Number of times the owner holds the lock. Only accessed with the lock held.
+    unsigned int depth_ = 0;
   };
 
   public:
@@ -34,6 +55,10 @@ class thread_safe_policy {
   using table_base = table_base_impl;
 };
 
+///\brief Thread safe policy using the default mutex.
+///\ingroup libhoard_api
+using thread_safe_policy = basic_thread_safe_policy<>;
+
 
 } /* namespace libhoard */
 
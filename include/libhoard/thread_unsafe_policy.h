@@ -24,6 +24,11 @@ class thread_unsafe_policy {
     }
 
     auto unlock() const noexcept -> void {}
+
+    ///\brief There is no lock to acquire, so the caller may always proceed.
+    constexpr auto owns_lock_() const noexcept -> bool {
+      return true;
+    }
   };
 
   public:
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+
+#include "detail/function_ref.h"
+
+namespace libhoard {
+
+
+template<typename Clock, bool ExpectValue> class max_age_policy_impl;
+template<typename Clock> class stale_while_revalidate_policy;
+
+namespace detail {
+
+
+///\brief Test if a policy expires values once they reach a certain age.
+template<typename Policy>
+struct limits_value_age_
+: std::false_type
+{};
+
+template<typename Clock>
+struct limits_value_age_<max_age_policy_impl<Clock, true>>
+: std::true_type
+{};
+
+template<typename Clock>
+struct limits_value_age_<stale_while_revalidate_policy<Clock>>
+: std::true_type
+{};
+
+
+} /* namespace libhoard::detail */
+
+
+/**
+ * \brief Policy that installs a second, larger tier behind the cache.
+ * \details
+ * When the cache evicts a value to stay within its limits, the value is demoted into the store.
+ * When a lookup misses the cache, the store is consulted before the resolver is invoked.
+ * Values found in the store are removed from it, and promoted back into the cache.
+ *
+ * Erasing or expiring a key in the cache also removes it from the store.
+ * Values that expire for other reasons (for example, because they are too old) are not demoted.
+ *
+ * The store is usually a file_store, but any type with the following member functions will do:
+ * - `put(std::size_t hash, const key_type& key, const mapped_type& value)`
+ * - `take(std::size_t hash, Matcher matcher) -> std::optional<mapped_type>`
+ * - `erase(std::size_t hash, Matcher matcher)`
+ * - `clear()`
+ *
+ * The store is guarded by a mutex of its own, which copies of the policy share.
+ * A sharded_cache, which constructs each shard from a copy of the policy,
+ * thus has all its shards demote into a single store safely.
+ * Policies constructed separately shouldn't be given the same store.
+ * Failures to demote a value are silently ignored, the value is simply dropped.
+ *
+ * Only makes sense in combination with a policy that evicts values, such as the max_size_policy.
+ *
+ * The store doesn't record how old a value is, so a promoted value counts as freshly loaded.
+ * This policy therefore can't be combined with a policy that limits the age of values,
+ * such as the max_age_policy or the stale_while_revalidate_policy:
+ * values would cycle through the store, and outlive their max age.
+ * Combining them is a compile-time error.
+ * Refresh policies restart their schedule when a value is promoted.
+ *
+ * \tparam Store The type of the second tier.
+ */
+template<typename Store>
+class tiered_policy {
+  public:
+  template<typename HashTable, typename ValueType, typename Allocator> class table_base;
+
+  tiered_policy() = delete;
+  explicit tiered_policy(std::shared_ptr<Store> store);
+
+  private:
+  std::shared_ptr<Store> store_;
+  std::shared_ptr<std::mutex> store_mtx_;
+};
+
+template<typename Store>
+template<typename HashTable, typename ValueType, typename Allocator>
+class tiered_policy<Store>::table_base {
+  public:
+  table_base(const tiered_policy& policy, const Allocator& alloc) noexcept;
+  table_base(tiered_policy&& policy, const Allocator& alloc) noexcept;
+
+  auto on_evict_(ValueType* vptr) noexcept -> void;
+  auto on_expire_(std::size_t hash, detail::function_ref<bool(const typename ValueType::key_type&)> matcher) noexcept -> void;
+  auto on_expire_all_() noexcept -> void;
+
+  template<typename... Keys>
+  auto fallback_get_(std::size_t hash, const Keys&... keys) -> std::optional<typename ValueType::mapped_type>;
+
+  private:
+  std::shared_ptr<Store> store_;
+  ///\brief Guards the store, which may be shared with other tables.
+  std::shared_ptr<std::mutex> store_mtx_;
+};
+
+
+} /* namespace libhoard */
+
+#include "tiered_policy.ii"
@@ -12,6 +12,10 @@ namespace libhoard {
  *
  * This policy has no effect if the cache doesn't hold smart pointers.
  *
+ * Weakened elements don't count towards the max_size_policy.
+ * Elements whose weak pointer has expired are removed by the queue,
+ * which sweeps a few cold elements during each maintenance cycle.
+ *
  * \note This policy doesn't add base types, instead the queue code checks
  * for presence and modifies behaviour accordingly.
  */
@@ -0,0 +1,58 @@
+#include <libhoard/any_cache_adapter.h>
+#include <libhoard/max_size_policy.h>
+
+#include <string>
+
+#include "UnitTest++/UnitTest++.h"
+
+// Instantiates all members of the adapter.
+template class libhoard::any_cache_adapter<int, std::string, libhoard::max_size_policy>;
+
+SUITE(any_cache) {
+  TEST(operations) {
+    libhoard::any_cache<int, std::string> c = libhoard::make_any_cache(libhoard::cache<int, std::string>());
+
+    c.emplace(1, "one");
+    CHECK_EQUAL(std::string("one"), c.get_if_exists(1).value_or("nothing"));
+    CHECK(!c.get_if_exists(2).has_value());
+
+    CHECK_EQUAL(std::string("one"), c.get_or_emplace(1, "uno"));
+    CHECK_EQUAL(std::string("two"), c.get_or_emplace(2, "two"));
+    CHECK_EQUAL(std::string("two"), c.get_if_exists(2).value_or("nothing"));
+
+    c.erase(1);
+    CHECK(!c.get_if_exists(1).has_value());
+    CHECK(c.get_if_exists(2).has_value());
+
+    c.clear();
+    CHECK(!c.get_if_exists(2).has_value());
+  }
+
+  TEST(shares_elements_with_cache) {
+    libhoard::cache<int, std::string> original;
+    libhoard::any_cache<int, std::string> c = libhoard::make_any_cache(original);
+
+    original.emplace(1, "one");
+    CHECK_EQUAL(std::string("one"), c.get_if_exists(1).value_or("nothing"));
+
+    c.emplace(2, "two");
+    CHECK_EQUAL(std::string("two"), original.get_if_exists(2).value_or("nothing"));
+
+    // Copies refer to the same cache.
+    libhoard::any_cache<int, std::string> copy = c;
+    copy.erase(1);
+    CHECK(!c.get_if_exists(1).has_value());
+  }
+
+  TEST(policies_apply) {
+    libhoard::any_cache<int, std::string> c = libhoard::make_any_cache(
+        libhoard::cache<int, std::string, libhoard::max_size_policy>(libhoard::max_size_policy(2)));
+
+    for (int i = 0; i < 10; ++i) c.emplace(i, std::to_string(i));
+
+    int count = 0;
+    for (int i = 0; i < 10; ++i)
+      if (c.get_if_exists(i).has_value()) ++count;
+    CHECK_EQUAL(2, count);
+  }
+}
@@ -3,6 +3,8 @@
 #include <chrono>
 #include <exception>
 #include <list>
+#include <map>
+#include <stdexcept>
 #include <string>
 
 #include "UnitTest++/UnitTest++.h"
@@ -161,3 +163,111 @@ SUITE(asio_refresh_fn_policy) {
     CHECK_EQUAL(2, call_count);
   }
 }
+
+SUITE(asio_batch_refresh_policy) {
+  class fixture {
+    public:
+    struct resolver_impl {
+      resolver_impl(fixture* self) : self(self) {}
+
+      template<typename CallbackPtr>
+      auto operator()(const CallbackPtr& callback_ptr, int n) const -> void {
+        ++self->resolver_called_count[n];
+        callback_ptr->assign(std::to_string(n) + "/" + std::to_string(self->resolver_called_count[n]));
+      }
+
+      fixture* self;
+    };
+
+    using asio_resolver_policy_type = libhoard::asio_resolver_policy<resolver_impl, asio::io_context::executor_type>;
+    using asio_refresh_policy_type = libhoard::asio_batch_refresh_policy<std::chrono::system_clock, asio::io_context::executor_type>;
+    using cache_type = libhoard::cache<int, std::string, asio_resolver_policy_type, asio_refresh_policy_type>;
+
+    std::map<int, int> resolver_called_count;
+    asio::io_context io_context;
+    cache_type cache = cache_type(asio_resolver_policy_type(resolver_impl(this), this->io_context.get_executor()), asio_refresh_policy_type(this->io_context.get_executor(), std::chrono::milliseconds(200), std::chrono::milliseconds(700)));
+  };
+
+  TEST_FIXTURE(fixture, refresh_many) {
+    int call_count = 0;
+    for (int i = 0; i < 5; ++i) {
+      cache.async_get(
+          [&call_count, i](std::string v, std::exception_ptr err) {
+            ++call_count;
+            CHECK_EQUAL(std::to_string(i) + "/1", v);
+            CHECK(err == nullptr);
+          },
+          i);
+    }
+
+    // Runs until the idle timer stops the refreshes.
+    io_context.run();
+
+    CHECK_EQUAL(5, call_count);
+    CHECK_EQUAL(5u, resolver_called_count.size());
+    for (const auto& [key, count] : resolver_called_count) {
+      CHECK(count >= 2);
+      CHECK(count <= 5);
+    }
+  }
+
+  TEST_FIXTURE(fixture, resolve) {
+    using namespace std::literals::chrono_literals;
+
+    int call_count = 0;
+    typename asio::steady_timer::rebind_executor<asio::io_context::executor_type>::other delay(io_context.get_executor());
+
+    cache.async_get(
+        [&call_count, &delay, this](std::string v, std::exception_ptr err) {
+          ++call_count;
+          CHECK_EQUAL("3/1", v);
+          CHECK(err == nullptr);
+
+          delay.expires_after(300ms);
+          delay.async_wait(
+              [&call_count, this](const auto& err) {
+                if (err) return;
+                this->cache.async_get(
+                    [&call_count](std::string v, std::exception_ptr err) {
+                      ++call_count;
+                      CHECK(v != "3/1");
+                      CHECK(err == nullptr);
+                    },
+                    3);
+              });
+        },
+        3);
+
+    io_context.run();
+
+    CHECK_EQUAL(2, call_count);
+  }
+
+  TEST(throwing_refresh_keeps_timer_armed) {
+    std::map<int, int> calls;
+
+    // The first refresh of key 3 throws, everything else resolves.
+    auto resolver = [&calls](const auto& callback_ptr, int n) {
+      const int count = ++calls[n];
+      if (n == 3 && count == 2) throw std::runtime_error("refresh failed");
+      callback_ptr->assign(std::to_string(n) + "/" + std::to_string(count));
+    };
+    using asio_resolver_policy_type = libhoard::asio_resolver_policy<decltype(resolver), asio::io_context::executor_type>;
+    using asio_refresh_policy_type = libhoard::asio_batch_refresh_policy<std::chrono::system_clock, asio::io_context::executor_type>;
+
+    asio::io_context io_context;
+    libhoard::cache<int, std::string, asio_resolver_policy_type, asio_refresh_policy_type> cache{
+        asio_resolver_policy_type(resolver, io_context.get_executor()),
+        asio_refresh_policy_type(io_context.get_executor(), std::chrono::milliseconds(200), std::chrono::milliseconds(700))};
+
+    // Both keys are due at the same time, so their refreshes happen from the same timer.
+    cache.async_get([]([[maybe_unused]] std::string v, [[maybe_unused]] std::exception_ptr err) {}, 3);
+    cache.async_get([]([[maybe_unused]] std::string v, [[maybe_unused]] std::exception_ptr err) {}, 4);
+
+    // Runs until the idle timer stops the refreshes.
+    io_context.run();
+
+    CHECK(calls[3] >= 2);
+    CHECK(calls[4] >= 3);
+  }
+}
@@ -0,0 +1,96 @@
+#include <libhoard/asio/resolve_timeout_policy.h>
+
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "UnitTest++/UnitTest++.h"
+
+#include <asio/io_context.hpp>
+#include <asio/steady_timer.hpp>
+
+#include <libhoard/asio/resolver_policy.h>
+#include <libhoard/cache.h>
+
+SUITE(asio_resolve_timeout_policy) {
+  class fixture {
+    public:
+    // Holds on to the callback, but never completes, unless told to.
+    struct resolver_impl {
+      resolver_impl(fixture* self) : self(self) {}
+
+      template<typename CallbackPtr>
+      auto operator()(CallbackPtr callback_ptr, int n) const -> void {
+        ++self->resolver_called_count;
+        if (self->respond)
+          callback_ptr->assign(std::to_string(n));
+        else
+          self->hung_callbacks.push_back(callback_ptr);
+      }
+
+      fixture* self;
+    };
+
+    using asio_resolver_policy_type = libhoard::asio_resolver_policy<resolver_impl, asio::io_context::executor_type>;
+    using timeout_policy_type = libhoard::asio_resolve_timeout_policy<std::chrono::steady_clock, asio::io_context::executor_type>;
+    using cache_type = libhoard::cache<int, std::string, asio_resolver_policy_type, timeout_policy_type>;
+
+    int resolver_called_count = 0;
+    bool respond = false;
+    std::vector<std::shared_ptr<void>> hung_callbacks;
+    asio::io_context io_context;
+    cache_type cache = cache_type(asio_resolver_policy_type(resolver_impl(this), this->io_context.get_executor()), timeout_policy_type(this->io_context.get_executor(), std::chrono::milliseconds(50)));
+  };
+
+  TEST_FIXTURE(fixture, timeout) {
+    int call_count = 0;
+
+    cache.async_get(
+        [&call_count, this]([[maybe_unused]] std::string v, std::exception_ptr err) {
+          ++call_count;
+          REQUIRE CHECK(err != nullptr);
+          try {
+            std::rethrow_exception(err);
+          } catch (const libhoard::resolve_timeout_error& e) {
+            CHECK(e.code() == std::errc::timed_out);
+          } catch (...) {
+            CHECK(false);
+          }
+
+          // The next lookup starts a fresh resolve.
+          respond = true;
+          cache.async_get(
+              [&call_count](std::string v, std::exception_ptr err) {
+                ++call_count;
+                CHECK(err == nullptr);
+                CHECK_EQUAL("3", v);
+              },
+              3);
+        },
+        3);
+
+    io_context.run();
+
+    CHECK_EQUAL(2, call_count);
+    CHECK_EQUAL(2, resolver_called_count);
+  }
+
+  TEST_FIXTURE(fixture, resolve_in_time) {
+    int call_count = 0;
+    respond = true;
+
+    cache.async_get(
+        [&call_count](std::string v, std::exception_ptr err) {
+          ++call_count;
+          CHECK(err == nullptr);
+          CHECK_EQUAL("3", v);
+        },
+        3);
+
+    io_context.run();
+    CHECK_EQUAL(1, call_count);
+  }
+}
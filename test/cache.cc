@@ -1,9 +1,36 @@
 #include <libhoard/cache.h>
+#include <libhoard/max_size_policy.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "UnitTest++/UnitTest++.h"
 
+namespace {
+
+// Allocator that counts how often it is used.
+template<typename T>
+struct counting_allocator : std::allocator<T> {
+  template<typename U> struct rebind { using other = counting_allocator<U>; };
+
+  counting_allocator() = default;
+  template<typename U> counting_allocator([[maybe_unused]] const counting_allocator<U>& other) noexcept {}
+
+  auto allocate(std::size_t n) -> T* {
+    ++count;
+    return std::allocator<T>::allocate(n);
+  }
+
+  static inline int count = 0;
+};
+
+} /* namespace <unnamed> */
+
 SUITE(cache) {
   class fixture {
     public:
@@ -131,4 +158,139 @@ SUITE(cache) {
     CHECK(seventeen.has_value());
     CHECK_EQUAL(std::string("bla bla bla chocoladevla"), *seventeen); // No replacement happened.
   }
+
+  TEST(string_view_lookup_does_not_allocate) {
+    using string_type = std::basic_string<char, std::char_traits<char>, counting_allocator<char>>;
+    libhoard::cache<string_type, int> cache;
+    cache.emplace(string_type("a key that is too long for the small string optimization"), 17);
+
+    const int allocations = counting_allocator<char>::count;
+    CHECK_EQUAL(17, cache.get(std::string_view("a key that is too long for the small string optimization")).value());
+    CHECK_EQUAL(17, cache.get_if_exists("a key that is too long for the small string optimization").value());
+    CHECK(!cache.get(std::string_view("another key that is too long for the small string optimization")).has_value());
+    CHECK_EQUAL(allocations, counting_allocator<char>::count);
+  }
+
+  TEST_FIXTURE(fixture, get_handle) {
+    auto one = cache.get_handle(1);
+    CHECK(bool(one));
+    if (one) CHECK_EQUAL(std::string("one"), *one);
+
+    // Handles refer to the value in the cache, instead of a copy.
+    auto one_again = cache.get_handle(1);
+    CHECK(one.get() == one_again.get());
+
+    auto three = cache.get_handle(3);
+    CHECK(!three);
+  }
+
+  TEST_FIXTURE(fixture, handle_outlives_erase) {
+    auto one = cache.get_handle(1);
+    cache.erase(1);
+    cache.emplace(1, "uno");
+
+    CHECK_EQUAL(std::string("one"), *one);
+    CHECK_EQUAL(std::string("uno"), cache.get(1).value());
+  }
+
+  TEST_FIXTURE(fixture, handle_copies_pin_the_value) {
+    auto one = cache.get_handle(1);
+    auto copy = one;
+    auto moved = std::move(one);
+    CHECK(!one);
+
+    cache.erase(1);
+    copy.reset();
+    CHECK(!copy);
+
+    // The moved handle still pins the value.
+    REQUIRE CHECK(bool(moved));
+    CHECK_EQUAL(std::string("one"), *moved);
+  }
+
+  TEST(erase_if) {
+    libhoard::cache<int, int> cache;
+    for (int i = 0; i < 100; ++i) cache.emplace(i, i * i);
+
+    const std::size_t erased = cache.erase_if([](int key, int value) { return key % 2 == 0 && value == key * key; });
+
+    CHECK_EQUAL(50u, erased);
+    for (int i = 0; i < 100; ++i) CHECK_EQUAL(i % 2 != 0, cache.get_if_exists(i).has_value());
+  }
+
+  TEST(erase_if_in_small_chunks) {
+    libhoard::cache<int, int> cache;
+    for (int i = 0; i < 100; ++i) cache.emplace(i, i);
+
+    const std::size_t erased = cache.erase_if([](int key, [[maybe_unused]] int value) { return key >= 10; }, 1);
+
+    CHECK_EQUAL(90u, erased);
+    for (int i = 0; i < 100; ++i) CHECK_EQUAL(i < 10, cache.get_if_exists(i).has_value());
+  }
+
+  TEST(for_each) {
+    libhoard::cache<int, int> cache;
+    for (int i = 0; i < 100; ++i) cache.emplace(i, i);
+    cache.erase(17);
+
+    std::vector<int> seen;
+    cache.for_each(
+        [&seen](int key, int value) {
+          CHECK_EQUAL(key, value);
+          seen.push_back(key);
+        },
+        3);
+
+    std::sort(seen.begin(), seen.end());
+    CHECK_EQUAL(99u, seen.size());
+    CHECK(std::adjacent_find(seen.begin(), seen.end()) == seen.end()); // Each element is visited once.
+    CHECK(!std::binary_search(seen.begin(), seen.end(), 17));
+  }
+
+  TEST(emplace_many) {
+    libhoard::cache<int, std::string> cache;
+    const std::vector<std::pair<int, std::string>> values{ { 1, "one" }, { 2, "two" }, { 1, "uno" } };
+
+    cache.emplace_many(values.begin(), values.end());
+
+    CHECK_EQUAL(std::string("uno"), cache.get_if_exists(1).value_or("nothing")); // Later pairs replace earlier ones.
+    CHECK_EQUAL(std::string("two"), cache.get_if_exists(2).value_or("nothing"));
+  }
+
+  TEST(emplace_many_from_container) {
+    libhoard::cache<int, std::shared_ptr<int>> cache;
+    std::map<int, std::shared_ptr<int>> values;
+    for (int i = 0; i < 100; ++i) values.emplace(i, std::make_shared<int>(i));
+
+    cache.emplace_many(values);
+    CHECK(values.at(17) != nullptr); // Copied from an lvalue.
+    cache.emplace_many(std::move(values));
+    CHECK(values.at(17) == nullptr); // Moved from an rvalue.
+
+    for (int i = 0; i < 100; ++i) {
+      const auto v = cache.get_if_exists(i);
+      REQUIRE CHECK(v.has_value() && *v != nullptr);
+      CHECK_EQUAL(i, **v);
+    }
+  }
+
+  TEST(emplace_many_evicts_like_emplace) {
+    using cache_type = libhoard::cache<int, int, libhoard::max_size_policy>;
+    cache_type expected(libhoard::max_size_policy(10));
+    cache_type cache(libhoard::max_size_policy(10));
+    std::vector<std::pair<int, int>> values;
+    for (int i = 0; i < 100; ++i) {
+      values.emplace_back(i, i);
+      expected.emplace(i, i);
+    }
+
+    cache.emplace_many(values);
+
+    int count = 0;
+    for (int i = 0; i < 100; ++i) {
+      CHECK_EQUAL(expected.get_if_exists(i).has_value(), cache.get_if_exists(i).has_value());
+      if (cache.get_if_exists(i).has_value()) ++count;
+    }
+    CHECK_EQUAL(10, count);
+  }
 }
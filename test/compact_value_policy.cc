@@ -0,0 +1,138 @@
+#include <libhoard/compact_value_policy.h>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "UnitTest++/UnitTest++.h"
+
+#include <libhoard/detail/hashtable.h>
+#include <libhoard/error_max_size_policy.h>
+#include <libhoard/max_age_policy.h>
+#include <libhoard/max_size_policy.h>
+#include <libhoard/resolver_policy.h>
+
+namespace {
+
+template<typename... Policies>
+using element_size = std::integral_constant<std::size_t, sizeof(typename libhoard::detail::hashtable<std::uint64_t, std::uint64_t, Policies...>::value_type)>;
+
+template<typename... Policies>
+using compact_element_size = element_size<Policies..., libhoard::compact_value_policy>;
+
+} /* namespace <unnamed> */
+
+SUITE(compact_value_policy) {
+  // Guard the element layout against regressions.
+  // The numbers are those of a 64-bit platform.
+  TEST(element_size) {
+    using libhoard::max_size_policy;
+    using max_age_policy = libhoard::max_age_policy<std::chrono::steady_clock>;
+
+    const std::size_t compact_none = compact_element_size<>::value;
+    const std::size_t compact_max_size = compact_element_size<max_size_policy>::value;
+    const std::size_t compact_max_age = compact_element_size<max_age_policy>::value;
+    const std::size_t compact_both = compact_element_size<max_size_policy, max_age_policy>::value;
+
+    if constexpr(sizeof(void*) == 8 && sizeof(std::size_t) == 8) {
+      CHECK_EQUAL(48u, compact_none);
+      CHECK_EQUAL(72u, compact_max_size);
+      CHECK_EQUAL(56u, compact_max_age);
+      CHECK_EQUAL(80u, compact_both);
+    }
+
+    CHECK(compact_none < element_size<>::value);
+    CHECK(compact_max_size < element_size<max_size_policy>::value);
+    CHECK(compact_max_age < element_size<max_age_policy>::value);
+    CHECK(compact_both < (element_size<max_size_policy, max_age_policy>::value));
+  }
+
+  TEST(emplace_and_get) {
+    using hashtable_type = libhoard::detail::hashtable<std::uint64_t, std::uint64_t, libhoard::max_size_policy, libhoard::compact_value_policy>;
+
+    auto table = std::make_shared<hashtable_type>(libhoard::max_size_policy(4));
+    for (std::uint64_t i = 0; i < 4; ++i) table->emplace(i, 2 * i);
+    for (std::uint64_t i = 0; i < 4; ++i) CHECK_EQUAL(2 * i, std::get<1>(table->get(i)));
+
+    table->expire(2);
+    CHECK_EQUAL(0u, table->get(2).index());
+  }
+
+  TEST(handle_outlives_expiry) {
+    using hashtable_type = libhoard::detail::hashtable<int, std::string, libhoard::compact_value_policy>;
+
+    auto table = std::make_shared<hashtable_type>();
+    table->emplace(0, "a value that is long enough to require memory allocation");
+    auto handle = hashtable_type::handle_type(table->get_handle(0));
+    const std::string* address = handle.get();
+
+    table->expire(0);
+    CHECK_EQUAL(0u, table->get_if_exists(0).index());
+    CHECK(address == handle.get());
+    CHECK_EQUAL(std::string("a value that is long enough to require memory allocation"), *handle);
+  }
+
+  class async_fixture {
+    public:
+    struct resolver_impl {
+      template<typename CallbackPtr>
+      auto operator()(CallbackPtr&& callback_ptr, int n) const -> void {
+        self->callbacks.emplace_back(
+            [callback_ptr=std::forward<CallbackPtr>(callback_ptr), n]() {
+              if (n < 0)
+                callback_ptr->assign_error(std::make_exception_ptr(std::runtime_error("negative key")));
+              else
+                callback_ptr->assign(n, 'x');
+            });
+      }
+
+      async_fixture* self;
+    };
+
+    using hashtable_type = libhoard::detail::hashtable<int, std::string,
+          libhoard::async_resolver_policy<resolver_impl>,
+          libhoard::error_max_size_policy,
+          libhoard::compact_value_policy>;
+
+    auto complete_all() -> void {
+      auto q = std::move(callbacks);
+      for (auto& cb : q) cb();
+    }
+
+    std::vector<std::function<void()>> callbacks;
+    std::shared_ptr<hashtable_type> table = std::make_shared<hashtable_type>(
+        libhoard::async_resolver_policy<resolver_impl>(resolver_impl{this}),
+        libhoard::error_max_size_policy(10));
+  };
+
+  TEST_FIXTURE(async_fixture, resolve_value_and_error) {
+    std::promise<std::string> three_prom, fail_prom;
+    auto three = three_prom.get_future(), fail = fail_prom.get_future();
+
+    auto to_promise = [](std::promise<std::string>& prom) {
+      return [&prom](const std::string& value, const std::exception_ptr& error, [[maybe_unused]] auto immediate) {
+        if (error)
+          prom.set_exception(error);
+        else
+          prom.set_value(value);
+      };
+    };
+    table->async_get(to_promise(three_prom), 3);
+    table->async_get(to_promise(fail_prom), -1);
+    REQUIRE CHECK_EQUAL(2u, callbacks.size());
+
+    complete_all();
+    CHECK_EQUAL(std::string("xxx"), three.get());
+    CHECK_THROW(fail.get(), std::runtime_error);
+
+    // Both the value and the error are cached.
+    CHECK_EQUAL(std::string("xxx"), std::get<1>(table->get_if_exists(3)));
+    CHECK_EQUAL(2u, table->get_if_exists(-1).index());
+  }
+}
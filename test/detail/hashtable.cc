@@ -1,6 +1,7 @@
 #include <libhoard/detail/hashtable.h>
 
 #include <functional>
+#include <map>
 #include <string>
 
 #include "UnitTest++/UnitTest++.h"
@@ -128,4 +129,27 @@ SUITE(hashtable) {
     auto get_result_2 = hashtable->get_if_exists("key_2");
     CHECK_EQUAL(std::string("value_2"), std::get<1>(get_result_2));
   }
+
+  TEST_FIXTURE(hashtable_fixture, walk_across_rehash) {
+    init_test();
+    for (int i = 0; i < 20; ++i) hashtable->emplace(std::to_string(i), std::to_string(i));
+
+    std::map<std::string, int> visits;
+    auto count_visits = [&visits](const std::string& key, [[maybe_unused]] const std::string& value) -> bool {
+      ++visits[key];
+      return false;
+    };
+
+    libhoard::detail::hashtable_walk_cursor cursor;
+    CHECK(!hashtable->walk_(cursor, 1, count_visits));
+
+    // Grow the table, so the remainder of the walk uses a different bucket layout.
+    const auto bucket_count = hashtable->bucket_count();
+    for (int i = 20; hashtable->bucket_count() == bucket_count; ++i) hashtable->emplace(std::to_string(i), std::to_string(i));
+
+    while (!hashtable->walk_(cursor, 1, count_visits));
+
+    for (int i = 0; i < 20; ++i) CHECK_EQUAL(1, visits[std::to_string(i)]);
+    for (const auto& [key, count] : visits) CHECK_EQUAL(1, count);
+  }
 }
@@ -0,0 +1,107 @@
+#include <libhoard/detail/indexed_heap.h>
+
+#include <array>
+#include <vector>
+
+#include "UnitTest++/UnitTest++.h"
+
+using libhoard::detail::indexed_heap;
+
+SUITE(indexed_heap) {
+  class indexed_heap_fixture {
+    public:
+    struct tag;
+
+    class element
+    : public libhoard::detail::indexed_heap_link<tag>
+    {
+      public:
+      explicit element(int key = 0) noexcept : key(key) {}
+
+      int key;
+    };
+
+    struct key_order {
+      auto operator()(const element& x, const element& y) const noexcept -> bool {
+        return x.key < y.key;
+      }
+    };
+
+    using heap_type = indexed_heap<element, tag, key_order>;
+
+    auto drain() -> std::vector<int> {
+      std::vector<int> result;
+      while (!heap.empty()) {
+        element* e = heap.pop();
+        CHECK(!e->is_linked());
+        result.push_back(e->key);
+      }
+      return result;
+    }
+
+    protected:
+    heap_type heap;
+  };
+
+  TEST_FIXTURE(indexed_heap_fixture, empty_heap) {
+    CHECK(heap.empty());
+    CHECK_EQUAL(0u, heap.size());
+  }
+
+  TEST_FIXTURE(indexed_heap_fixture, pop_in_order) {
+    std::array<element, 7> elems{ element(5), element(3), element(9), element(1), element(7), element(3), element(0) };
+    for (element& e : elems) heap.push(&e);
+
+    CHECK_EQUAL(7u, heap.size());
+    CHECK_EQUAL(0, heap.top()->key);
+    CHECK((std::vector<int>{ 0, 1, 3, 3, 5, 7, 9 }) == drain());
+  }
+
+  TEST_FIXTURE(indexed_heap_fixture, erase) {
+    std::array<element, 6> elems{ element(5), element(3), element(9), element(1), element(7), element(4) };
+    for (element& e : elems) heap.push(&e);
+
+    heap.erase(&elems[1]); // 3
+    heap.erase(&elems[3]); // 1, the top
+    heap.erase(&elems[2]); // 9
+    CHECK(!elems[1].is_linked());
+    CHECK(!elems[3].is_linked());
+    CHECK(elems[0].is_linked());
+
+    CHECK((std::vector<int>{ 4, 5, 7 }) == drain());
+  }
+
+  TEST_FIXTURE(indexed_heap_fixture, update) {
+    std::array<element, 5> elems{ element(5), element(3), element(9), element(1), element(7) };
+    for (element& e : elems) heap.push(&e);
+
+    elems[2].key = 0; // 9 -> 0
+    heap.update(&elems[2]);
+    elems[3].key = 8; // 1 -> 8
+    heap.update(&elems[3]);
+
+    CHECK((std::vector<int>{ 0, 3, 5, 7, 8 }) == drain());
+  }
+
+  TEST_FIXTURE(indexed_heap_fixture, reserve) {
+    std::array<element, 4> elems{ element(4), element(3), element(2), element(1) };
+    heap.reserve(elems.size());
+    const std::size_t capacity = heap.capacity();
+    CHECK(capacity >= elems.size());
+
+    for (element& e : elems) heap.push(&e);
+    CHECK_EQUAL(capacity, heap.capacity()); // The heap didn't grow.
+
+    CHECK(drain() == std::vector<int>({ 1, 2, 3, 4 }));
+  }
+
+  TEST_FIXTURE(indexed_heap_fixture, copies_are_not_linked) {
+    element e(1);
+    heap.push(&e);
+
+    element copy = e;
+    CHECK(e.is_linked());
+    CHECK(!copy.is_linked());
+    heap.erase(&e);
+  }
+}
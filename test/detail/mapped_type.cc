@@ -343,6 +343,19 @@ SUITE(mapped_value) {
     CHECK_EQUAL(0, matcher_invocation_count);
     CHECK(result == expected);
   }
+
+  TEST_FIXTURE(mapped_value_fixture, pin_unpin) {
+    init_test(std::piecewise_construct, std::make_tuple("foobar"));
+    CHECK(!value->pinned());
+
+    value->pin();
+    value->pin();
+    value->unpin();
+    CHECK(value->pinned());
+
+    value->unpin();
+    CHECK(!value->pinned());
+  }
 }
 
 
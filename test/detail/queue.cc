@@ -26,8 +26,13 @@ class queue_fixture_impl {
       strong(strong)
     {}
 
-    auto strengthen() {
+    auto strengthen() -> bool {
       strong = true;
+      return true;
+    }
+
+    auto pending() const -> bool {
+      return false;
     }
 
     auto weaken() {
@@ -59,6 +64,8 @@ class queue_fixture_impl {
     auto lru_expire_(std::size_t count) noexcept {
       return this->libhoard::detail::queue<impl, element>::lru_expire_(count);
     }
+
+    auto on_evict_([[maybe_unused]] element* e) noexcept -> void {}
   };
 
   protected:
@@ -193,6 +200,39 @@ SUITE(queue) {
     CHECK(!elems[1].expired);
   }
 
+  TEST_FIXTURE(weaken_queue_fixture, lru_expire_skips_weakened_elements) {
+    init_test();
+    std::array<element, 4> elems{
+      element(*queue, false),
+      element(*queue, false),
+      element(*queue, false),
+      element(*queue, false),
+    };
+    for (auto& e : elems) queue->on_create_(&e);
+    // Elements 1 and 3 are cold, with element 1 being the coldest.
+    REQUIRE CHECK(!elems[1].strong);
+    REQUIRE CHECK(!elems[3].strong);
+    elems[1].strong = elems[3].strong = true;
+
+    queue->lru_expire_(1);
+    CHECK(!elems[1].strong);
+    CHECK(elems[3].strong);
+    CHECK_EQUAL(1u, queue->weak_size());
+
+    queue->lru_expire_(1);
+    CHECK(!elems[3].strong);
+    CHECK_EQUAL(2u, queue->weak_size());
+
+    // A hit strengthens the element, so it is no longer weak.
+    queue->on_hit_(&elems[1]);
+    CHECK_EQUAL(1u, queue->weak_size());
+
+    // Unlinking a weakened element removes it from the count.
+    queue->on_unlink_(&elems[3]);
+    CHECK_EQUAL(0u, queue->weak_size());
+    CHECK(queue->invariant());
+  }
+
   TEST_FIXTURE(queue_fixture, unlinking) {
     init_test();
     std::array<element, 8> elems{
@@ -1,7 +1,13 @@
 #include <libhoard/detail/refcount.h>
 
+#include <memory>
+#include <type_traits>
+
 #include "UnitTest++/UnitTest++.h"
 
+#include <libhoard/detail/hashtable.h>
+#include <libhoard/thread_unsafe_policy.h>
+
 SUITE(refcount) {
   class fixture {
     public:
@@ -133,6 +139,23 @@ SUITE(refcount) {
     CHECK_EQUAL(1u, deallocate_called);
   }
 
+  TEST_FIXTURE(fixture, reset_shared) {
+    {
+      auto ptr_1 = libhoard::detail::allocate_refcount<type>(allocator());
+      auto ptr_2 = ptr_1;
+      reset_counters();
+
+      // Releases the reference, without destroying the instance.
+      ptr_1.reset();
+      CHECK_EQUAL(nullptr, ptr_1.get());
+      CHECK_EQUAL(&instance, ptr_2.get());
+      CHECK_EQUAL(0u, deallocate_called);
+    }
+
+    // Destruction still happens once.
+    CHECK_EQUAL(1u, deallocate_called);
+  }
+
   TEST_FIXTURE(fixture, copy_construction) {
     {
       auto ptr_1 = libhoard::detail::allocate_refcount<type>(allocator());
@@ -265,4 +288,28 @@ SUITE(refcount) {
     CHECK(ptr_2 == nullptr);
     CHECK(!(ptr_2 != nullptr));
   }
+
+  TEST(unsynchronized_refcount) {
+    struct type : libhoard::detail::unsynchronized_refcount {};
+    static_assert(libhoard::detail::is_refcounted_v<type>);
+
+    auto ptr_1 = libhoard::detail::allocate_refcount<type>(std::allocator<type>());
+    CHECK_EQUAL(1u, libhoard::detail::refcount_load(ptr_1.get()));
+
+    {
+      auto ptr_2 = ptr_1;
+      CHECK_EQUAL(2u, libhoard::detail::refcount_load(ptr_1.get()));
+    }
+    CHECK_EQUAL(1u, libhoard::detail::refcount_load(ptr_1.get()));
+  }
+
+  TEST(thread_unsafe_cache_uses_unsynchronized_refcount) {
+    using unsafe_table = libhoard::detail::hashtable<int, int, libhoard::thread_unsafe_policy>;
+    using safe_table = libhoard::detail::hashtable<int, int>;
+
+    static_assert(std::is_base_of_v<libhoard::detail::unsynchronized_refcount, unsafe_table::value_type>);
+    static_assert(!std::is_base_of_v<libhoard::detail::refcount, unsafe_table::value_type>);
+    static_assert(std::is_base_of_v<libhoard::detail::refcount, safe_table::value_type>);
+    static_assert(!std::is_base_of_v<libhoard::detail::unsynchronized_refcount, safe_table::value_type>);
+  }
 }
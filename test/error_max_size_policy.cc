@@ -0,0 +1,78 @@
+#include <libhoard/error_max_size_policy.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+#include "UnitTest++/UnitTest++.h"
+
+#include <libhoard/detail/hashtable.h>
+#include <libhoard/max_size_policy.h>
+#include <libhoard/resolver_policy.h>
+
+SUITE(error_max_size_policy) {
+  // Resolves negative keys to an error, and other keys to a string.
+  struct resolver_impl {
+    auto operator()(int n) const -> std::tuple<std::string::size_type, char> {
+      if (n < 0) throw std::runtime_error("negative key");
+      return std::make_tuple(std::string::size_type(n), 'x');
+    }
+  };
+
+  TEST(limiting_errors) {
+    using hashtable_type = libhoard::detail::hashtable<int, std::string, libhoard::resolver_policy<resolver_impl>, libhoard::error_max_size_policy>;
+
+    auto table = std::make_shared<hashtable_type>(libhoard::resolver_policy<resolver_impl>(), libhoard::error_max_size_policy(2));
+    for (int i = 1; i <= 5; ++i) {
+      CHECK_EQUAL(2u, table->get(-i).index());
+      CHECK_EQUAL(std::min(i, 2), static_cast<int>(table->error_count()));
+    }
+
+    // Only the two most recent errors are retained.
+    CHECK_EQUAL(0u, table->get_if_exists(-1).index());
+    CHECK_EQUAL(0u, table->get_if_exists(-2).index());
+    CHECK_EQUAL(0u, table->get_if_exists(-3).index());
+    CHECK_EQUAL(2u, table->get_if_exists(-4).index());
+    CHECK_EQUAL(2u, table->get_if_exists(-5).index());
+  }
+
+  TEST(values_are_not_limited) {
+    using hashtable_type = libhoard::detail::hashtable<int, std::string, libhoard::resolver_policy<resolver_impl>, libhoard::error_max_size_policy>;
+
+    auto table = std::make_shared<hashtable_type>(libhoard::resolver_policy<resolver_impl>(), libhoard::error_max_size_policy(1));
+    for (int i = 1; i <= 5; ++i) {
+      CHECK_EQUAL(1u, table->get(i).index());
+      CHECK_EQUAL(2u, table->get(-i).index());
+    }
+
+    CHECK_EQUAL(1u, table->error_count());
+    for (int i = 1; i <= 5; ++i)
+      CHECK_EQUAL(std::string(i, 'x'), std::get<1>(table->get_if_exists(i)));
+  }
+
+  TEST(hit_refreshes_error) {
+    using hashtable_type = libhoard::detail::hashtable<int, std::string, libhoard::resolver_policy<resolver_impl>, libhoard::error_max_size_policy>;
+
+    auto table = std::make_shared<hashtable_type>(libhoard::resolver_policy<resolver_impl>(), libhoard::error_max_size_policy(2));
+    table->get(-1);
+    table->get(-2);
+    table->get(-1); // Makes -2 the least recently used error.
+    table->get(-3);
+
+    CHECK_EQUAL(2u, table->get_if_exists(-1).index());
+    CHECK_EQUAL(0u, table->get_if_exists(-2).index());
+    CHECK_EQUAL(2u, table->get_if_exists(-3).index());
+  }
+
+  TEST(errors_dont_evict_working_set) {
+    using hashtable_type = libhoard::detail::hashtable<int, std::string, libhoard::resolver_policy<resolver_impl>, libhoard::max_size_policy, libhoard::error_max_size_policy>;
+
+    auto table = std::make_shared<hashtable_type>(libhoard::resolver_policy<resolver_impl>(), libhoard::max_size_policy(10), libhoard::error_max_size_policy(2));
+    for (int i = 1; i <= 8; ++i) table->get(i);
+    for (int i = 1; i <= 100; ++i) table->get(-i);
+
+    for (int i = 1; i <= 8; ++i)
+      CHECK_EQUAL(1u, table->get_if_exists(i).index());
+  }
+}
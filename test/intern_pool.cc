@@ -0,0 +1,145 @@
+#include <libhoard/intern_pool.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "UnitTest++/UnitTest++.h"
+
+SUITE(intern_pool) {
+  inline std::size_t allocations = 0;
+
+  template<typename T>
+  struct counting_allocator {
+    using value_type = T;
+
+    counting_allocator() noexcept = default;
+    template<typename U>
+    counting_allocator([[maybe_unused]] const counting_allocator<U>& y) noexcept {}
+
+    auto allocate(std::size_t n) -> T* {
+      ++allocations;
+      return std::allocator<T>().allocate(n);
+    }
+
+    auto deallocate(T* p, std::size_t n) -> void {
+      std::allocator<T>().deallocate(p, n);
+    }
+
+    template<typename U>
+    auto operator==([[maybe_unused]] const counting_allocator<U>& y) const noexcept -> bool { return true; }
+    template<typename U>
+    auto operator!=([[maybe_unused]] const counting_allocator<U>& y) const noexcept -> bool { return false; }
+  };
+
+  using pool_type = libhoard::intern_pool<char>;
+
+  TEST(intern) {
+    pool_type pool;
+
+    auto h = pool.intern("foo");
+    CHECK(h);
+    CHECK_EQUAL(std::string("foo"), std::string(h.view()));
+    CHECK_EQUAL(std::string("foo"), std::string(h.c_str()));
+    CHECK_EQUAL(3u, h.size());
+    CHECK_EQUAL(std::hash<std::string_view>()("foo"), h.hash());
+    CHECK_EQUAL(1u, pool.size());
+  }
+
+  TEST(same_string_same_handle) {
+    pool_type pool;
+    const std::string foo = "foo";
+
+    auto h1 = pool.intern("foo");
+    auto h2 = pool.intern(foo);
+    CHECK(h1 == h2);
+    CHECK_EQUAL(static_cast<const void*>(h1.c_str()), static_cast<const void*>(h2.c_str()));
+    CHECK_EQUAL(1u, pool.size());
+  }
+
+  TEST(distinct_strings) {
+    pool_type pool;
+
+    auto h1 = pool.intern("foo");
+    auto h2 = pool.intern("bar");
+    auto h3 = pool.intern("");
+    CHECK(h1 != h2);
+    CHECK(h1 != h3);
+    CHECK(h3);
+    CHECK_EQUAL(std::string(""), std::string(h3.c_str()));
+    CHECK_EQUAL(3u, pool.size());
+  }
+
+  TEST(intern_substring) {
+    pool_type pool;
+    const std::string_view text = "foobar";
+
+    auto h = pool.intern(text.substr(0, 3));
+    CHECK(h == pool.intern("foo"));
+    CHECK_EQUAL(std::string("foo"), std::string(h.c_str())); // The copy is null-terminated.
+  }
+
+  TEST(find_does_not_intern) {
+    pool_type pool;
+
+    CHECK(!pool.find("foo"));
+    CHECK_EQUAL(0u, pool.size());
+
+    auto h = pool.intern("foo");
+    CHECK(h == pool.find("foo"));
+  }
+
+  TEST(release) {
+    pool_type pool;
+
+    auto h1 = pool.intern("foo");
+    auto h2 = h1;
+    h1 = pool_type::handle();
+    CHECK_EQUAL(1u, pool.size());
+    h2 = pool_type::handle();
+    CHECK_EQUAL(0u, pool.size());
+    CHECK(!pool.find("foo"));
+  }
+
+  TEST(handle_outlives_pool) {
+    pool_type::handle h;
+    {
+      pool_type pool;
+      h = pool.intern("foo");
+    }
+    CHECK_EQUAL(std::string("foo"), std::string(h.view()));
+  }
+
+  TEST(hit_does_not_allocate) {
+    libhoard::intern_pool<char, std::char_traits<char>, counting_allocator<char>> pool;
+
+    auto h1 = pool.intern("a long string, that won't fit in the small string buffer");
+    const std::size_t allocations_before = allocations;
+    auto h2 = pool.intern("a long string, that won't fit in the small string buffer");
+    auto h3 = h2;
+    CHECK_EQUAL(allocations_before, allocations);
+    CHECK(h1 == h2);
+  }
+
+  TEST(concurrent_intern_and_release) {
+    pool_type pool;
+    const std::vector<std::string> names{ "a", "b", "c", "d" };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back(
+          [&pool, &names]() {
+            for (int i = 0; i < 10000; ++i) {
+              auto h = pool.intern(names[i % names.size()]);
+              if (h.view() != names[i % names.size()]) std::terminate();
+            }
+          });
+    }
+    for (auto& t : threads) t.join();
+
+    CHECK_EQUAL(0u, pool.size());
+  }
+}
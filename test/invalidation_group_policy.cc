@@ -0,0 +1,118 @@
+#include <libhoard/invalidation_group_policy.h>
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "UnitTest++/UnitTest++.h"
+
+#include <libhoard/cache.h>
+#include <libhoard/max_size_policy.h>
+#include <libhoard/resolver_policy.h>
+
+SUITE(invalidation_group_policy) {
+  ///\brief Tag elements by their hundreds.
+  struct hundreds {
+    auto operator()(int key) const -> int { return key / 100; }
+  };
+
+  ///\brief Tag elements by parity, and by whether they're small.
+  struct parity_and_size {
+    auto operator()(int key) const -> std::vector<std::string> {
+      std::vector<std::string> tags{ key % 2 == 0 ? "even" : "odd" };
+      if (key < 10) tags.push_back("small");
+      tags.push_back(tags.front()); // Duplicate tags are ignored.
+      return tags;
+    }
+  };
+
+  using cache_type = libhoard::cache<int, std::string,
+        libhoard::invalidation_group_policy<int, hundreds>>;
+
+  TEST(invalidate_group) {
+    cache_type cache;
+    for (int i : { 100, 101, 102, 200, 201 }) cache.emplace(i, std::to_string(i));
+
+    cache.invalidate_group(1);
+    CHECK(!cache.get_if_exists(100).has_value());
+    CHECK(!cache.get_if_exists(101).has_value());
+    CHECK(!cache.get_if_exists(102).has_value());
+    CHECK_EQUAL(std::string("200"), cache.get_if_exists(200).value_or("<missing>"));
+    CHECK_EQUAL(std::string("201"), cache.get_if_exists(201).value_or("<missing>"));
+
+    cache.invalidate_group(3); // Unknown group.
+    CHECK(cache.get_if_exists(200).has_value());
+
+    // Elements added after the invalidation join the group again.
+    cache.emplace(103, "103");
+    CHECK(cache.get_if_exists(103).has_value());
+    cache.invalidate_group(1);
+    CHECK(!cache.get_if_exists(103).has_value());
+  }
+
+  TEST(multiple_groups) {
+    libhoard::cache<int, std::string,
+        libhoard::invalidation_group_policy<std::string, parity_and_size>> cache;
+    for (int i : { 1, 2, 3, 4, 11, 12 }) cache.emplace(i, std::to_string(i));
+
+    cache.invalidate_group("small");
+    CHECK(!cache.get_if_exists(1).has_value());
+    CHECK(!cache.get_if_exists(4).has_value());
+    CHECK(cache.get_if_exists(11).has_value());
+    CHECK(cache.get_if_exists(12).has_value());
+
+    // Elements that were removed via the "small" group, also left the "even" group.
+    cache.invalidate_group("even");
+    CHECK(cache.get_if_exists(11).has_value());
+    CHECK(!cache.get_if_exists(12).has_value());
+  }
+
+  TEST(evicted_elements_leave_their_group) {
+    libhoard::cache<int, std::string,
+        libhoard::invalidation_group_policy<int, hundreds>,
+        libhoard::max_size_policy> cache(libhoard::max_size_policy(2));
+    for (int i = 100; i < 110; ++i) cache.emplace(i, std::to_string(i));
+    cache.emplace(200, "200");
+
+    cache.invalidate_group(1);
+    for (int i = 100; i < 110; ++i) CHECK(!cache.get_if_exists(i).has_value());
+    CHECK(cache.get_if_exists(200).has_value());
+  }
+
+  class pending_fixture {
+    public:
+    struct resolver_impl {
+      explicit resolver_impl(pending_fixture* self) noexcept : self(self) {}
+
+      template<typename CallbackPtr>
+      auto operator()(const CallbackPtr& callback_ptr, int n) const -> void {
+        self->callbacks.emplace_back(
+            [callback_ptr, n]() { callback_ptr->assign(std::to_string(n)); });
+      }
+
+      pending_fixture*const self;
+    };
+
+    using cache_type = libhoard::cache<int, std::string,
+          libhoard::async_resolver_policy<resolver_impl>,
+          libhoard::invalidation_group_policy<int, hundreds>>;
+
+    std::vector<std::function<void()>> callbacks;
+    cache_type cache = cache_type(libhoard::async_resolver_policy<resolver_impl>(resolver_impl(this)));
+  };
+
+  TEST_FIXTURE(pending_fixture, invalidate_cancels_pending_lookups) {
+    auto first = cache.get(100);
+    CHECK_EQUAL(1u, callbacks.size());
+
+    // New lookups don't join the pending lookup after invalidation.
+    cache.invalidate_group(1);
+    auto second = cache.get(100);
+    CHECK_EQUAL(2u, callbacks.size());
+
+    for (auto& cb : callbacks) cb();
+    CHECK_EQUAL(std::string("100"), std::get<0>(first.get()));
+    CHECK_EQUAL(std::string("100"), std::get<0>(second.get()));
+  }
+}
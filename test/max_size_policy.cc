@@ -24,4 +24,26 @@ SUITE(max_size_policy) {
       CHECK_EQUAL(maxsize, table->count()); // Policy keeps cache size at desired `maxsize` elements.
     }
   }
+
+  TEST(handle_outlives_eviction) {
+    constexpr unsigned int maxsize = 5;
+    using libhoard::detail::hashtable;
+    using libhoard::max_size_policy;
+    using hashtable_type = hashtable<int, std::string, max_size_policy>;
+
+    auto table = std::make_shared<hashtable_type>(max_size_policy(maxsize));
+    table->emplace(0, "a value that is long enough to require memory allocation");
+    auto handle = hashtable_type::handle_type(table->get_handle(0));
+    const std::string* address = handle.get();
+
+    // Taking the handle made the element hot, so make newer elements hotter.
+    for (unsigned int i = 1; i < maxsize * 2u; ++i) {
+      table->emplace(i, "bla");
+      table->get(i);
+    }
+    CHECK_EQUAL(0u, table->get_if_exists(0).index()); // Element was evicted.
+
+    CHECK(address == handle.get());
+    CHECK_EQUAL(std::string("a value that is long enough to require memory allocation"), *handle);
+  }
 }
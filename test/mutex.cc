@@ -0,0 +1,86 @@
+#include <libhoard/mutex.h>
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "UnitTest++/UnitTest++.h"
+
+namespace {
+
+
+template<typename Mutex>
+auto check_exclusion() -> bool {
+  constexpr int thread_count = 4;
+  constexpr int iterations = 20000;
+
+  Mutex mtx;
+  int counter = 0;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thread_count; ++i) {
+    threads.emplace_back(
+        [&mtx, &counter]() {
+          for (int j = 0; j < iterations; ++j) {
+            std::lock_guard<Mutex> lck{ mtx };
+            ++counter;
+          }
+        });
+  }
+  for (auto& thr : threads) thr.join();
+
+  return counter == thread_count * iterations;
+}
+
+
+} /* namespace <unnamed> */
+
+SUITE(spin_mutex) {
+  TEST(try_lock) {
+    libhoard::spin_mutex mtx;
+
+    CHECK(mtx.try_lock());
+    CHECK(!mtx.try_lock());
+    mtx.unlock();
+    CHECK(mtx.try_lock());
+    mtx.unlock();
+  }
+
+  TEST(mutual_exclusion) {
+    CHECK(check_exclusion<libhoard::spin_mutex>());
+  }
+}
+
+SUITE(adaptive_mutex) {
+  TEST(try_lock) {
+    libhoard::adaptive_mutex mtx;
+
+    CHECK(mtx.try_lock());
+    CHECK(!mtx.try_lock());
+    mtx.unlock();
+    CHECK(mtx.try_lock());
+    mtx.unlock();
+  }
+
+  TEST(mutual_exclusion) {
+    CHECK(check_exclusion<libhoard::adaptive_mutex>());
+  }
+
+  TEST(sleeping_waiter_is_woken) {
+    libhoard::adaptive_mutex mtx;
+    bool acquired = false;
+
+    mtx.lock();
+    std::thread waiter(
+        [&mtx, &acquired]() {
+          std::lock_guard<libhoard::adaptive_mutex> lck{ mtx };
+          acquired = true;
+        });
+    // Hold the lock long enough for the waiter to stop spinning.
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    mtx.unlock();
+    waiter.join();
+
+    CHECK(acquired);
+  }
+}
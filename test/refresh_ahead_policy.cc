@@ -0,0 +1,109 @@
+#include <libhoard/refresh_ahead_policy.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+
+#include "UnitTest++/UnitTest++.h"
+
+#include <libhoard/cache.h>
+#include <libhoard/max_age_policy.h>
+#include <libhoard/resolver_policy.h>
+
+SUITE(refresh_ahead_policy) {
+  using clock = std::chrono::steady_clock;
+  using namespace std::literals::chrono_literals;
+
+  class fixture {
+    public:
+    struct resolver_impl {
+      explicit resolver_impl(fixture* self) : self(self) {}
+
+      auto operator()(int key) const -> std::tuple<std::string> {
+        return std::make_tuple(std::to_string(key) + "/" + std::to_string(++self->calls));
+      }
+
+      fixture* self;
+    };
+
+    using cache_type = libhoard::cache<int, std::string,
+          libhoard::resolver_policy<resolver_impl>,
+          libhoard::max_age_policy<clock>,
+          libhoard::refresh_ahead_policy<clock>>;
+
+    auto make_cache(std::chrono::milliseconds max_age, clock::duration delta) -> cache_type {
+      return cache_type(
+          libhoard::resolver_policy<resolver_impl>(resolver_impl(this)),
+          libhoard::max_age_policy<clock>(max_age),
+          libhoard::refresh_ahead_policy<clock>(delta));
+    }
+
+    std::atomic<int> calls{ 0 };
+  };
+
+  TEST_FIXTURE(fixture, hit_near_expiry_refreshes) {
+    // With a delta this large, every hit is close enough to the expiry.
+    cache_type cache = make_cache(10s, 1h);
+
+    CHECK_EQUAL("3/1", cache.get(3)); // Miss: resolved.
+    CHECK_EQUAL("3/1", cache.get(3)); // Hit: starts a background refresh.
+
+    const auto deadline = clock::now() + 10s;
+    while (cache.get_if_exists(3) != std::optional<std::string>("3/2") && clock::now() < deadline)
+      std::this_thread::sleep_for(1ms);
+    CHECK_EQUAL("3/2", cache.get_if_exists(3).value_or("nothing"));
+  }
+
+  TEST_FIXTURE(fixture, hit_far_from_expiry_does_not_refresh) {
+    cache_type cache = make_cache(1h, 1ns);
+
+    for (int i = 0; i < 100; ++i) CHECK_EQUAL("3/1", cache.get(3));
+    std::this_thread::sleep_for(10ms);
+    CHECK_EQUAL(1, calls.load());
+  }
+
+  TEST_FIXTURE(fixture, unread_values_expire) {
+    cache_type cache = make_cache(50ms, 1ns);
+
+    CHECK_EQUAL("3/1", cache.get(3));
+    std::this_thread::sleep_for(100ms);
+    CHECK(!cache.get_if_exists(3).has_value());
+    CHECK_EQUAL(1, calls.load());
+  }
+
+  TEST(throwing_refresh_is_dropped) {
+    std::atomic<int> calls{ 0 };
+
+    // The first refresh throws, everything else resolves.
+    auto resolver = [&calls](const auto& callback_ptr, int key) {
+      const int n = ++calls;
+      if (n == 2) throw std::runtime_error("refresh failed");
+      callback_ptr->assign(std::to_string(key) + "/" + std::to_string(n));
+    };
+    libhoard::cache<int, std::string,
+        libhoard::async_resolver_policy<decltype(resolver)>,
+        libhoard::max_age_policy<clock>,
+        libhoard::refresh_ahead_policy<clock>> cache{
+            libhoard::async_resolver_policy<decltype(resolver)>(resolver),
+            libhoard::max_age_policy<clock>(10s),
+            libhoard::refresh_ahead_policy<clock>(1h)};
+    auto get = [&cache](int key) { return std::get<0>(cache.get(key).get()); };
+
+    CHECK_EQUAL("3/1", get(3));
+    CHECK_EQUAL("3/1", get(3)); // Starts the refresh that throws.
+
+    const auto deadline = clock::now() + 10s;
+    while (calls < 2 && clock::now() < deadline) std::this_thread::sleep_for(1ms);
+    REQUIRE CHECK(calls >= 2);
+
+    // The worker survived, and performs the next refresh.
+    CHECK_EQUAL("4/3", get(4));
+    CHECK_EQUAL("4/3", get(4));
+    while (cache.get_if_exists(4) != std::optional<std::string>("4/4") && clock::now() < deadline)
+      std::this_thread::sleep_for(1ms);
+    CHECK_EQUAL("4/4", cache.get_if_exists(4).value_or("nothing"));
+  }
+}
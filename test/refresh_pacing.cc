@@ -0,0 +1,58 @@
+#include <libhoard/refresh_pacing.h>
+
+#include <chrono>
+
+#include "UnitTest++/UnitTest++.h"
+
+SUITE(refresh_pacing) {
+  using clock = std::chrono::steady_clock;
+  using namespace std::literals::chrono_literals;
+
+  TEST(default_has_no_jitter_or_rate_limit) {
+    libhoard::refresh_pacing<clock> pacing;
+    const clock::time_point now = clock::now();
+
+    CHECK(!pacing.rate_limited());
+    CHECK(now + 10s == pacing.next_refresh(now, 10s));
+    for (int i = 0; i < 100; ++i)
+      CHECK(now == pacing.acquire(now));
+  }
+
+  TEST(jitter_moves_refresh_forward) {
+    libhoard::refresh_pacing<clock> pacing(0.25);
+    const clock::time_point now = clock::now();
+
+    bool saw_jitter = false;
+    for (int i = 0; i < 100; ++i) {
+      const clock::time_point tp = pacing.next_refresh(now, 100s);
+      CHECK(tp >= now + 75s);
+      CHECK(tp <= now + 100s);
+      if (tp != now + 100s) saw_jitter = true;
+    }
+    CHECK(saw_jitter);
+  }
+
+  TEST(rate_limit_postpones_to_next_slot) {
+    libhoard::refresh_pacing<clock> pacing(0.0, 10.0); // 10 per second.
+    const clock::time_point now = clock::now();
+
+    CHECK(pacing.rate_limited());
+    CHECK(now == pacing.acquire(now));
+    CHECK(now + 100ms == pacing.acquire(now));
+    CHECK(now + 200ms == pacing.acquire(now));
+
+    // Unused slots are not saved up beyond the burst size.
+    CHECK(now + 10s == pacing.acquire(now + 10s));
+    CHECK(now + 10s + 100ms == pacing.acquire(now + 10s));
+  }
+
+  TEST(rate_limit_allows_burst) {
+    libhoard::refresh_pacing<clock> pacing(0.0, 10.0, 3);
+    const clock::time_point now = clock::now();
+
+    CHECK(now == pacing.acquire(now));
+    CHECK(now == pacing.acquire(now));
+    CHECK(now == pacing.acquire(now));
+    CHECK(now + 100ms == pacing.acquire(now));
+  }
+}
@@ -1,8 +1,12 @@
 #include <libhoard/refresh_policy.h>
 
+#include <atomic>
 #include <chrono>
+#include <future>
 #include <list>
 #include <memory>
+#include <optional>
+#include <stdexcept>
 #include <string>
 #include <system_error>
 #include <thread>
@@ -10,6 +14,7 @@
 
 #include "UnitTest++/UnitTest++.h"
 
+#include <libhoard/cache.h>
 #include <libhoard/resolver_policy.h>
 #include <libhoard/detail/hashtable.h>
 
@@ -112,4 +117,272 @@ SUITE(refresh_policy) {
       CHECK_EQUAL(0u, value.index());
     }
   }
+
+  TEST(refresh_does_not_hold_lock) {
+    using namespace std::literals::chrono_literals;
+    std::promise<void> release;
+    const std::shared_future<void> released = release.get_future().share();
+    std::atomic<int> calls{ 0 };
+
+    // The first call resolves immediately, refreshes block until released.
+    auto resolver = [&calls, released](int key) {
+      const int n = calls++;
+      if (n > 0) released.wait();
+      return std::make_tuple(n == 0 ? std::string("first") : std::to_string(key));
+    };
+    libhoard::cache<int, std::string,
+        libhoard::resolver_policy<decltype(resolver)>,
+        libhoard::refresh_policy<std::chrono::system_clock>> cache(
+            libhoard::resolver_policy<decltype(resolver)>(resolver),
+            libhoard::refresh_policy<std::chrono::system_clock>(100ms, std::chrono::system_clock::duration::zero(), 2));
+
+    CHECK_EQUAL("first", cache.get(3));
+
+    // Wait for the refresh to start.
+    const auto deadline = std::chrono::steady_clock::now() + 10s;
+    while (calls < 2 && std::chrono::steady_clock::now() < deadline) std::this_thread::sleep_for(10ms);
+    REQUIRE CHECK(calls >= 2);
+
+    // While the refresh is in progress, the old value is served without waiting for the resolver.
+    auto lookup = std::async(std::launch::async, [&cache]() { return cache.get(3); });
+    const bool lookup_completed = (lookup.wait_for(5s) == std::future_status::ready);
+    release.set_value();
+    CHECK(lookup_completed);
+    CHECK_EQUAL("first", lookup.get());
+
+    // Once the refresh completes, the new value is installed.
+    while (cache.get_if_exists(3) != std::optional<std::string>("3") && std::chrono::steady_clock::now() < deadline)
+      std::this_thread::sleep_for(10ms);
+    CHECK_EQUAL("3", cache.get_if_exists(3).value_or("nothing"));
+  }
+
+  // Runs \p action while a refresh of key 3 is waiting for the resolver.
+  // Only the initial value refreshes, so the refresh that raced the action is the only one.
+  template<typename Action, typename Check>
+  void race_refresh(Action action, Check check) {
+    using namespace std::literals::chrono_literals;
+    std::promise<void> release;
+    const std::shared_future<void> released = release.get_future().share();
+    std::atomic<int> calls{ 0 };
+    std::atomic<bool> returned{ false };
+
+    auto resolver = [&calls, &returned, released]([[maybe_unused]] int key) {
+      const int n = calls++;
+      if (n > 0) {
+        released.wait();
+        returned = true;
+      }
+      return std::make_tuple(n == 0 ? std::string("first") : std::string("refreshed"));
+    };
+    auto refresh_fn = [](const std::string& value) -> std::chrono::system_clock::duration {
+      if (value == "first") return 50ms;
+      return 1h;
+    };
+    using cache_type = libhoard::cache<int, std::string,
+        libhoard::resolver_policy<decltype(resolver)>,
+        libhoard::refresh_fn_policy<std::chrono::system_clock, decltype(refresh_fn)>>;
+    cache_type cache{
+        libhoard::resolver_policy<decltype(resolver)>(resolver),
+        libhoard::refresh_fn_policy<std::chrono::system_clock, decltype(refresh_fn)>(refresh_fn)};
+
+    CHECK_EQUAL("first", cache.get(3));
+
+    // Wait for the refresh to start.
+    const auto deadline = std::chrono::steady_clock::now() + 10s;
+    while (calls < 2 && std::chrono::steady_clock::now() < deadline) std::this_thread::sleep_for(10ms);
+    REQUIRE CHECK(calls >= 2);
+
+    action(cache);
+    release.set_value();
+
+    // Give the refresh time to complete.
+    while (!returned && std::chrono::steady_clock::now() < deadline) std::this_thread::sleep_for(10ms);
+    std::this_thread::sleep_for(100ms);
+    check(cache);
+  }
+
+  TEST(refresh_races_erase) {
+    race_refresh(
+        [](auto& cache) { cache.erase(3); },
+        [](auto& cache) { CHECK(!cache.get_if_exists(3).has_value()); });
+  }
+
+  TEST(refresh_races_clear) {
+    race_refresh(
+        [](auto& cache) { cache.clear(); },
+        [](auto& cache) { CHECK(!cache.get_if_exists(3).has_value()); });
+  }
+
+  TEST(refresh_races_emplace) {
+    race_refresh(
+        [](auto& cache) { cache.emplace(3, "emplaced"); },
+        [](auto& cache) {
+          CHECK_EQUAL("emplaced", cache.get_if_exists(3).value_or("nothing"));
+          // There is only a single element for the key.
+          int count = 0;
+          cache.for_each([&count]([[maybe_unused]] int key, [[maybe_unused]] const std::string& value) { ++count; });
+          CHECK_EQUAL(1, count);
+        });
+  }
+
+  // Policy that makes linking new elements fail, while the flag is set.
+  class failing_link_policy {
+    public:
+    template<typename HashTable, typename ValueType, typename Allocator>
+    class table_base {
+      public:
+      table_base(const failing_link_policy& policy, [[maybe_unused]] const Allocator& alloc) noexcept
+      : fail(policy.fail),
+        failures(policy.failures)
+      {}
+
+      auto on_reserve_([[maybe_unused]] ValueType* vptr) -> void {
+        if (*fail) {
+          ++*failures;
+          throw std::runtime_error("link failed");
+        }
+      }
+
+      private:
+      std::atomic<bool>* fail;
+      std::atomic<int>* failures;
+    };
+
+    failing_link_policy(std::atomic<bool>& fail, std::atomic<int>& failures) noexcept
+    : fail(&fail),
+      failures(&failures)
+    {}
+
+    private:
+    std::atomic<bool>* fail;
+    std::atomic<int>* failures;
+  };
+
+  TEST(throwing_refresh_is_dropped) {
+    using namespace std::literals::chrono_literals;
+    std::atomic<int> calls{ 0 };
+    std::atomic<bool> fail{ false };
+    std::atomic<int> failures{ 0 };
+
+    auto resolver = [&calls]([[maybe_unused]] int key) {
+      return std::make_tuple(std::to_string(++calls));
+    };
+    using cache_type = libhoard::cache<int, std::string,
+        libhoard::resolver_policy<decltype(resolver)>,
+        libhoard::refresh_policy<std::chrono::system_clock>,
+        failing_link_policy>;
+    cache_type cache{
+        libhoard::resolver_policy<decltype(resolver)>(resolver),
+        libhoard::refresh_policy<std::chrono::system_clock>(50ms, std::chrono::system_clock::duration::zero(), 1),
+        failing_link_policy(fail, failures)};
+
+    CHECK_EQUAL("1", cache.get(3));
+
+    // The refresh fails to install its value.
+    fail = true;
+    const auto deadline = std::chrono::steady_clock::now() + 10s;
+    while (failures == 0 && std::chrono::steady_clock::now() < deadline) std::this_thread::sleep_for(10ms);
+    fail = false;
+    REQUIRE CHECK(failures > 0);
+    CHECK_EQUAL("1", cache.get_if_exists(3).value_or("nothing"));
+
+    // The worker survived, and keeps refreshing other values.
+    const std::string initial = cache.get(4);
+    while (cache.get_if_exists(4) == std::optional<std::string>(initial) && std::chrono::steady_clock::now() < deadline)
+      std::this_thread::sleep_for(10ms);
+    CHECK(cache.get_if_exists(4).value_or(initial) != initial);
+  }
+
+  TEST(refresh_fn) {
+    using namespace std::literals::chrono_literals;
+    std::atomic<int> calls{ 0 };
+
+    auto resolver = [&calls](int key) {
+      return std::make_tuple(std::to_string(key) + "/" + std::to_string(++calls));
+    };
+    // Key 1 refreshes quickly, key 2 doesn't refresh during the test.
+    auto refresh_fn = [](const std::string& value) -> std::chrono::system_clock::duration {
+      if (value.compare(0, 2, "1/") == 0) return 50ms;
+      return 1h;
+    };
+
+    libhoard::cache<int, std::string,
+        libhoard::resolver_policy<decltype(resolver)>,
+        libhoard::refresh_fn_policy<std::chrono::system_clock, decltype(refresh_fn)>> cache(
+            libhoard::resolver_policy<decltype(resolver)>(resolver),
+            libhoard::refresh_fn_policy<std::chrono::system_clock, decltype(refresh_fn)>(refresh_fn, std::chrono::system_clock::duration::zero()));
+
+    CHECK_EQUAL("2/1", cache.get(2));
+    CHECK_EQUAL("1/2", cache.get(1));
+
+    // Key 1 keeps being refreshed, key 2 keeps its value.
+    const auto deadline = std::chrono::steady_clock::now() + 10s;
+    while (calls < 4 && std::chrono::steady_clock::now() < deadline) std::this_thread::sleep_for(10ms);
+    CHECK(calls >= 4);
+    CHECK_EQUAL("2/1", cache.get_if_exists(2).value_or("nothing"));
+    CHECK(cache.get_if_exists(1).value_or("nothing") != "1/2");
+  }
+
+  TEST(throwing_refresh_fn_refresh_is_dropped) {
+    using namespace std::literals::chrono_literals;
+    std::atomic<int> calls{ 0 };
+    std::atomic<bool> fail{ false };
+    std::atomic<int> failures{ 0 };
+
+    auto resolver = [&calls]([[maybe_unused]] int key) {
+      return std::make_tuple(std::to_string(++calls));
+    };
+    auto refresh_fn = []([[maybe_unused]] const std::string& value) -> std::chrono::system_clock::duration {
+      return 50ms;
+    };
+    using cache_type = libhoard::cache<int, std::string,
+        libhoard::resolver_policy<decltype(resolver)>,
+        libhoard::refresh_fn_policy<std::chrono::system_clock, decltype(refresh_fn)>,
+        failing_link_policy>;
+    cache_type cache{
+        libhoard::resolver_policy<decltype(resolver)>(resolver),
+        libhoard::refresh_fn_policy<std::chrono::system_clock, decltype(refresh_fn)>(refresh_fn, std::chrono::system_clock::duration::zero(), 1),
+        failing_link_policy(fail, failures)};
+
+    CHECK_EQUAL("1", cache.get(3));
+
+    // The refresh fails to install its value.
+    fail = true;
+    const auto deadline = std::chrono::steady_clock::now() + 10s;
+    while (failures == 0 && std::chrono::steady_clock::now() < deadline) std::this_thread::sleep_for(10ms);
+    fail = false;
+    REQUIRE CHECK(failures > 0);
+    CHECK_EQUAL("1", cache.get_if_exists(3).value_or("nothing"));
+
+    // The worker survived, and keeps refreshing other values.
+    const std::string initial = cache.get(4);
+    while (cache.get_if_exists(4) == std::optional<std::string>(initial) && std::chrono::steady_clock::now() < deadline)
+      std::this_thread::sleep_for(10ms);
+    CHECK(cache.get_if_exists(4).value_or(initial) != initial);
+  }
+
+  TEST(refresh_fn_time_point) {
+    using namespace std::literals::chrono_literals;
+    std::atomic<int> calls{ 0 };
+
+    auto resolver = [&calls](int key) {
+      return std::make_tuple(std::to_string(key) + "/" + std::to_string(++calls));
+    };
+    auto refresh_fn = []([[maybe_unused]] const std::string& value) {
+      return std::chrono::system_clock::now() + 50ms;
+    };
+
+    libhoard::cache<int, std::string,
+        libhoard::resolver_policy<decltype(resolver)>,
+        libhoard::refresh_fn_policy<std::chrono::system_clock, decltype(refresh_fn)>> cache(
+            libhoard::resolver_policy<decltype(resolver)>(resolver),
+            libhoard::refresh_fn_policy<std::chrono::system_clock, decltype(refresh_fn)>(refresh_fn, std::chrono::system_clock::duration::zero()));
+
+    CHECK_EQUAL("3/1", cache.get(3));
+
+    const auto deadline = std::chrono::steady_clock::now() + 10s;
+    while (cache.get_if_exists(3) == std::optional<std::string>("3/1") && std::chrono::steady_clock::now() < deadline)
+      std::this_thread::sleep_for(10ms);
+    CHECK(cache.get_if_exists(3).value_or("nothing") != "3/1");
+  }
 }
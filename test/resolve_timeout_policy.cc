@@ -0,0 +1,101 @@
+#include <libhoard/resolve_timeout_policy.h>
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "UnitTest++/UnitTest++.h"
+
+#include <libhoard/cache.h>
+#include <libhoard/resolver_policy.h>
+
+SUITE(resolve_timeout_policy) {
+  class fixture {
+    public:
+    // Callbacks are held until the test completes them.
+    struct resolver_impl {
+      resolver_impl(fixture* self) : self(self) {}
+
+      template<typename CallbackPtr>
+      auto operator()(const CallbackPtr& callback_ptr, int n) const -> void {
+        std::lock_guard<std::mutex> lck{ self->mtx };
+        ++self->resolve_count;
+        self->callbacks.emplace_back(
+            [callback_ptr, n]() { callback_ptr->assign(std::to_string(n)); });
+      }
+
+      fixture*const self;
+    };
+
+    using cache_type = libhoard::cache<int, std::string,
+          libhoard::async_resolver_policy<resolver_impl>,
+          libhoard::resolve_timeout_policy<std::chrono::steady_clock>>;
+
+    auto complete_all() -> void {
+      std::vector<std::function<void()>> cbs;
+      {
+        std::lock_guard<std::mutex> lck{ mtx };
+        cbs.swap(callbacks);
+      }
+      for (auto& cb : cbs) cb();
+    }
+
+    std::mutex mtx;
+    int resolve_count = 0;
+    std::vector<std::function<void()>> callbacks;
+    cache_type cache = cache_type(
+        libhoard::async_resolver_policy<resolver_impl>(this),
+        libhoard::resolve_timeout_policy<std::chrono::steady_clock>(std::chrono::milliseconds(50)));
+  };
+
+  TEST_FIXTURE(fixture, resolve_in_time) {
+    auto f = cache.get(3);
+    complete_all();
+    CHECK_EQUAL("3", std::get<0>(f.get()));
+    CHECK_EQUAL(1, resolve_count);
+  }
+
+  TEST_FIXTURE(fixture, timeout) {
+    using namespace std::literals::chrono_literals;
+
+    auto f1 = cache.get(3);
+    auto f2 = cache.get(3);
+    REQUIRE CHECK(f1.wait_for(5s) == std::future_status::ready);
+    REQUIRE CHECK(f2.wait_for(5s) == std::future_status::ready);
+
+    for (auto* f : { &f1, &f2 }) {
+      const auto result = f->get();
+      REQUIRE CHECK_EQUAL(1u, result.index());
+      try {
+        std::rethrow_exception(std::get<1>(result));
+      } catch (const libhoard::resolve_timeout_error& e) {
+        CHECK(e.code() == std::errc::timed_out);
+      } catch (...) {
+        CHECK(false);
+      }
+    }
+    CHECK_EQUAL(1, resolve_count);
+  }
+
+  TEST_FIXTURE(fixture, new_resolve_after_timeout) {
+    using namespace std::literals::chrono_literals;
+
+    auto f1 = cache.get(3);
+    REQUIRE CHECK(f1.wait_for(5s) == std::future_status::ready);
+    CHECK_EQUAL(1u, f1.get().index());
+
+    // The next lookup starts a new resolve.
+    auto f2 = cache.get(3);
+    CHECK_EQUAL(2, resolve_count);
+    complete_all(); // Completes both the old and the new resolve.
+    CHECK_EQUAL("3", std::get<0>(f2.get()));
+    CHECK_EQUAL("3", cache.get_if_exists(3).value_or("nothing"));
+  }
+}
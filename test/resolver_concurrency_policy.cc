@@ -0,0 +1,129 @@
+#include <libhoard/resolver_concurrency_policy.h>
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "UnitTest++/UnitTest++.h"
+
+#include <libhoard/cache.h>
+#include <libhoard/resolver_policy.h>
+
+SUITE(resolver_concurrency_policy) {
+  class fixture {
+    public:
+    // Callbacks are held until the test completes them.
+    struct resolver_impl {
+      resolver_impl(fixture* self) : self(self) {}
+
+      template<typename CallbackPtr>
+      auto operator()(const CallbackPtr& callback_ptr, int n) const -> void {
+        if (self->immediate) {
+          callback_ptr->assign(std::to_string(n));
+          return;
+        }
+
+        self->started.push_back(n);
+        self->callbacks.emplace_back(
+            [callback_ptr, n]() { callback_ptr->assign(std::to_string(n)); });
+      }
+
+      fixture*const self;
+    };
+
+    using cache_type = libhoard::cache<int, std::string,
+          libhoard::async_resolver_policy<resolver_impl>,
+          libhoard::resolver_concurrency_policy>;
+    using future_type = decltype(std::declval<cache_type&>().get(0));
+
+    auto complete_first() -> void {
+      auto cb = std::move(callbacks.front());
+      callbacks.erase(callbacks.begin());
+      cb();
+    }
+
+    bool immediate = false;
+    std::vector<int> started;
+    std::vector<std::function<void()>> callbacks;
+    cache_type cache = cache_type(
+        libhoard::async_resolver_policy<resolver_impl>(this),
+        libhoard::resolver_concurrency_policy(2));
+  };
+
+  TEST_FIXTURE(fixture, limits_in_flight) {
+    std::vector<future_type> futures;
+    for (int i = 0; i < 5; ++i) futures.push_back(cache.get(i));
+
+    CHECK((std::vector<int>{ 0, 1 }) == started);
+    auto stats = cache.resolver_concurrency_stats();
+    CHECK_EQUAL(2u, stats.in_flight);
+    CHECK_EQUAL(3u, stats.queued);
+    CHECK_EQUAL(3u, stats.delayed);
+
+    // Completing a resolve starts the next one, in FIFO order.
+    complete_first();
+    CHECK((std::vector<int>{ 0, 1, 2 }) == started);
+    CHECK_EQUAL(2u, cache.resolver_concurrency_stats().in_flight);
+    CHECK_EQUAL(2u, cache.resolver_concurrency_stats().queued);
+
+    while (!callbacks.empty()) complete_first();
+    CHECK((std::vector<int>{ 0, 1, 2, 3, 4 }) == started);
+    stats = cache.resolver_concurrency_stats();
+    CHECK_EQUAL(0u, stats.in_flight);
+    CHECK_EQUAL(0u, stats.queued);
+    CHECK_EQUAL(3u, stats.delayed);
+
+    for (int i = 0; i < 5; ++i)
+      CHECK_EQUAL(std::to_string(i), std::get<0>(futures[i].get()));
+  }
+
+  TEST_FIXTURE(fixture, same_key_is_resolved_once) {
+    auto f1 = cache.get(7);
+    auto f2 = cache.get(7);
+
+    CHECK((std::vector<int>{ 7 }) == started);
+    CHECK_EQUAL(1u, cache.resolver_concurrency_stats().in_flight);
+    complete_first();
+    CHECK_EQUAL("7", std::get<0>(f1.get()));
+    CHECK_EQUAL("7", std::get<0>(f2.get()));
+  }
+
+  TEST_FIXTURE(fixture, immediate_resolvers_drain_queue) {
+    std::vector<future_type> futures;
+    for (int i = 0; i < 3; ++i) futures.push_back(cache.get(i));
+    CHECK_EQUAL(1u, cache.resolver_concurrency_stats().queued);
+
+    // The queued resolve completes immediately.
+    immediate = true;
+    complete_first();
+    complete_first();
+
+    const auto stats = cache.resolver_concurrency_stats();
+    CHECK_EQUAL(0u, stats.in_flight);
+    CHECK_EQUAL(0u, stats.queued);
+    for (int i = 0; i < 3; ++i)
+      CHECK_EQUAL(std::to_string(i), std::get<0>(futures[i].get()));
+  }
+
+  TEST_FIXTURE(fixture, wait_time_is_tracked) {
+    using namespace std::literals::chrono_literals;
+
+    auto f0 = cache.get(0);
+    auto f1 = cache.get(1);
+    auto f2 = cache.get(2);
+
+    std::this_thread::sleep_for(20ms);
+    CHECK(cache.resolver_concurrency_stats().oldest_wait >= 20ms);
+
+    complete_first();
+    CHECK(cache.resolver_concurrency_stats().total_wait >= 20ms);
+    CHECK(cache.resolver_concurrency_stats().oldest_wait == std::chrono::steady_clock::duration::zero());
+    while (!callbacks.empty()) complete_first();
+  }
+}
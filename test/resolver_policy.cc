@@ -52,6 +52,15 @@ SUITE(resolver_policy) {
     CHECK_EQUAL(std::string("xxxx"), four);
   }
 
+  TEST_FIXTURE(fixture, get_handle) {
+    auto three = cache.get_handle(3);
+    CHECK_EQUAL(std::string("xxx"), *three);
+    CHECK(three.get() == cache.get_handle(3).get());
+
+    error = std::make_exception_ptr(std::runtime_error("'error'"));
+    CHECK_THROW(cache.get_handle(4), std::runtime_error);
+  }
+
   TEST_FIXTURE(fixture, async_get) {
     std::future<std::string> three;
 
@@ -0,0 +1,111 @@
+#include <libhoard/sharded_cache.h>
+#include <libhoard/max_size_policy.h>
+#include <libhoard/resolver_policy.h>
+
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "UnitTest++/UnitTest++.h"
+
+SUITE(sharded_cache) {
+  TEST(shard_count_rounds_up) {
+    CHECK_EQUAL(1u, (libhoard::sharded_cache<int, std::string>(0).shard_count()));
+    CHECK_EQUAL(1u, (libhoard::sharded_cache<int, std::string>(1).shard_count()));
+    CHECK_EQUAL(8u, (libhoard::sharded_cache<int, std::string>(5).shard_count()));
+  }
+
+  TEST(emplace_and_get) {
+    libhoard::sharded_cache<int, std::string> c(4);
+    c.emplace(1, "one");
+    c.emplace(std::piecewise_construct, std::make_tuple(2), std::make_tuple(3, 'x'));
+
+    CHECK_EQUAL(std::string("one"), c.get(1).value_or("nothing"));
+    CHECK_EQUAL(std::string("xxx"), c.get_if_exists(2).value_or("nothing"));
+    CHECK(!c.get(3).has_value());
+    CHECK_EQUAL(std::string("three"), c.get_or_emplace(3, "three"));
+    CHECK_EQUAL(std::string("three"), c.get_if_exists(3).value_or("nothing"));
+
+    auto h = c.get_handle(1);
+    REQUIRE CHECK(bool(h));
+    CHECK_EQUAL(std::string("one"), *h);
+  }
+
+  TEST(keys_live_in_their_shard) {
+    libhoard::sharded_cache<int, std::string> c(4);
+    for (int i = 0; i < 100; ++i) c.emplace(i, std::to_string(i));
+
+    std::set<const void*> used_shards;
+    for (int i = 0; i < 100; ++i) {
+      CHECK_EQUAL(std::to_string(i), c.shard(i).get_if_exists(i).value_or("nothing"));
+      used_shards.insert(&c.shard(i));
+    }
+    CHECK_EQUAL(4u, used_shards.size());
+  }
+
+  TEST(erase_and_clear) {
+    libhoard::sharded_cache<int, std::string> c(4);
+    for (int i = 0; i < 10; ++i) c.emplace(i, std::to_string(i));
+
+    c.erase(3);
+    CHECK(!c.get_if_exists(3).has_value());
+    CHECK(c.get_if_exists(4).has_value());
+
+    c.clear();
+    for (int i = 0; i < 10; ++i) CHECK(!c.get_if_exists(i).has_value());
+  }
+
+  TEST(erase_if_and_for_each) {
+    libhoard::sharded_cache<int, std::string> c(4);
+    for (int i = 0; i < 100; ++i) c.emplace(i, std::to_string(i));
+
+    CHECK_EQUAL(50u, c.erase_if([](int key, [[maybe_unused]] const std::string& value) { return key % 2 == 0; }));
+
+    std::set<int> seen;
+    c.for_each([&seen](int key, [[maybe_unused]] const std::string& value) { seen.insert(key); });
+    CHECK_EQUAL(50u, seen.size());
+    for (int key : seen) CHECK(key % 2 != 0);
+  }
+
+  TEST(policies_apply_per_shard) {
+    libhoard::sharded_cache<int, std::string, libhoard::max_size_policy> c(2, libhoard::max_size_policy(1));
+    c.emplace(0, "zero");
+
+    // Find a key in the other shard.
+    int other = 1;
+    while (&c.shard(other) == &c.shard(0)) ++other;
+    c.emplace(other, "other");
+
+    CHECK(c.get_if_exists(0).has_value());
+    CHECK(c.get_if_exists(other).has_value());
+  }
+
+  TEST(resolver) {
+    auto resolver = [](int i) { return std::make_tuple(std::to_string(i)); };
+    libhoard::sharded_cache<int, std::string, libhoard::resolver_policy<decltype(resolver)>> c(4, libhoard::resolver_policy<decltype(resolver)>(resolver));
+
+    CHECK_EQUAL(std::string("7"), c.get(7));
+    CHECK_EQUAL(std::string("7"), c.get_if_exists(7).value_or("nothing"));
+  }
+
+  TEST(concurrent_access) {
+    libhoard::sharded_cache<int, int> c(8);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back(
+          [&c, t]() {
+            for (int i = 0; i < 1000; ++i) {
+              c.emplace(t * 1000 + i, i);
+              c.get(t * 1000 + i);
+            }
+          });
+    }
+    for (std::thread& thr : threads) thr.join();
+
+    for (int t = 0; t < 4; ++t) {
+      for (int i = 0; i < 1000; ++i)
+        CHECK_EQUAL(i, c.get_if_exists(t * 1000 + i).value_or(-1));
+    }
+  }
+}
@@ -2,11 +2,13 @@
 #include <libhoard/cache.h>
 
 #include <memory>
+#include <vector>
 
 #include "UnitTest++/UnitTest++.h"
 
 #include <libhoard/weaken_policy.h>
 #include <libhoard/max_size_policy.h>
+#include <libhoard/detail/hashtable.h>
 
 SUITE(shared_pointer) {
   using cache_type = libhoard::cache<int, std::shared_ptr<int>,
@@ -40,4 +42,45 @@ SUITE(shared_pointer) {
     cause_expiry(cache);
     CHECK_EQUAL(std::shared_ptr<int>(nullptr), cache.get(1).value_or(nullptr));
   }
+
+  TEST(weakened_elements_dont_count_towards_size) {
+    using hashtable_type = libhoard::detail::hashtable<int, std::shared_ptr<int>,
+          libhoard::pointer_policy<>,
+          libhoard::weaken_policy,
+          libhoard::max_size_policy>;
+    auto table = std::make_shared<hashtable_type>(libhoard::max_size_policy(2), libhoard::pointer_policy<>());
+
+    std::vector<std::shared_ptr<int>> holders;
+    for (int i = 0; i < 10; ++i) {
+      holders.push_back(std::make_shared<int>(i));
+      table->emplace(i, holders.back());
+    }
+
+    // All elements are still alive, but the cold half is only weakly held by the cache.
+    // (The queue never weakens hot elements.)
+    CHECK_EQUAL(10u, table->count());
+    CHECK_EQUAL(10u, table->size());
+    CHECK_EQUAL(5u, table->weak_size());
+  }
+
+  TEST(dead_weakened_elements_are_swept) {
+    using hashtable_type = libhoard::detail::hashtable<int, std::shared_ptr<int>,
+          libhoard::pointer_policy<>,
+          libhoard::weaken_policy,
+          libhoard::max_size_policy>;
+    auto table = std::make_shared<hashtable_type>(libhoard::max_size_policy(2), libhoard::pointer_policy<>());
+
+    std::vector<std::shared_ptr<int>> holders;
+    for (int i = 0; i < 100; ++i) {
+      holders.push_back(std::make_shared<int>(i));
+      table->emplace(i, holders.back());
+    }
+    REQUIRE CHECK_EQUAL(100u, table->size());
+
+    // Once the values die, maintenance removes their elements, without any lookups for them.
+    holders.clear();
+    for (int i = 0; i < 100; ++i) table->emplace(-1, std::make_shared<int>(-1));
+    CHECK(table->size() <= 3u);
+    CHECK(table->weak_size() <= 1u);
+  }
 }
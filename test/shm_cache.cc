@@ -0,0 +1,150 @@
+#include <libhoard/shm_cache.h>
+
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "UnitTest++/UnitTest++.h"
+
+SUITE(shm_cache) {
+  ///\brief Codec that kills the process while decoding, if asked to.
+  struct dying_codec {
+    static inline bool die = false;
+
+    static auto encode(std::string_view v) noexcept -> std::string_view {
+      return libhoard::snapshot_codec<std::string>::encode(v);
+    }
+
+    static auto decode(std::string_view bytes) -> std::string {
+      if (die) _exit(0);
+      return libhoard::snapshot_codec<std::string>::decode(bytes);
+    }
+  };
+
+  ///\brief Run \p fn in a child process, and return its exit status.
+  template<typename Fn>
+  auto run_child(Fn&& fn) -> int {
+    const pid_t pid = fork();
+    if (pid == -1) throw std::runtime_error("fork failed");
+    if (pid == 0) _exit(fn());
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+  }
+
+  using cache_type = libhoard::shm_cache<std::string, std::string>;
+
+  TEST(emplace_get_erase) {
+    cache_type cache(4, 64);
+    CHECK_EQUAL(4u, cache.capacity());
+    CHECK(!cache.get_if_exists("foo").has_value());
+
+    cache.emplace("foo", "bar");
+    CHECK_EQUAL(1u, cache.size());
+    CHECK_EQUAL(std::string("bar"), cache.get_if_exists("foo").value_or("<missing>"));
+
+    cache.emplace("foo", "baz");
+    CHECK_EQUAL(1u, cache.size());
+    CHECK_EQUAL(std::string("baz"), cache.get_if_exists("foo").value_or("<missing>"));
+
+    cache.erase("foo");
+    CHECK_EQUAL(0u, cache.size());
+    CHECK(!cache.get_if_exists("foo").has_value());
+  }
+
+  TEST(trivially_copyable_types) {
+    libhoard::shm_cache<int, double> cache(4, 64);
+
+    cache.emplace(short(1), 2); // Both the key and the value are converted.
+    CHECK_EQUAL(2.0, cache.get_if_exists(1).value_or(0.0));
+  }
+
+  TEST(evicts_least_recently_used) {
+    cache_type cache(2, 64);
+
+    cache.emplace("one", "1");
+    cache.emplace("two", "2");
+    cache.get_if_exists("one");
+    cache.emplace("three", "3");
+
+    CHECK_EQUAL(2u, cache.size());
+    CHECK(cache.get_if_exists("one").has_value());
+    CHECK(!cache.get_if_exists("two").has_value());
+    CHECK(cache.get_if_exists("three").has_value());
+  }
+
+  TEST(entry_too_large) {
+    cache_type cache(2, 8);
+
+    CHECK_THROW(cache.emplace("key", "too large"), std::length_error);
+    CHECK_EQUAL(0u, cache.size());
+  }
+
+  TEST(clear) {
+    cache_type cache(4, 64);
+    cache.emplace("one", "1");
+    cache.emplace("two", "2");
+
+    cache.clear();
+    CHECK_EQUAL(0u, cache.size());
+    cache.emplace("three", "3");
+    CHECK_EQUAL(1u, cache.size());
+  }
+
+  TEST(shared_with_child_process) {
+    cache_type cache(16, 64);
+    cache.emplace("parent", "p");
+
+    const int status = run_child(
+        [&cache]() {
+          if (cache.get_if_exists("parent") != std::string("p")) return 1;
+          cache.emplace("child", "c");
+          return 0;
+        });
+    CHECK_EQUAL(0, status);
+
+    CHECK_EQUAL(std::string("c"), cache.get_if_exists("child").value_or("<missing>"));
+  }
+
+  TEST(named_segment) {
+    const std::string name = "/libhoard-test-" + std::to_string(getpid());
+    cache_type cache = cache_type::create(name, 16, 64);
+    cache.emplace("creator", "1");
+
+    const int status = run_child(
+        [&name]() {
+          cache_type opened = cache_type::open(name);
+          if (opened.capacity() != 16u || opened.get_if_exists("creator") != std::string("1")) return 1;
+          opened.emplace("opener", "2");
+          return 0;
+        });
+    cache_type::unlink(name);
+    CHECK_EQUAL(0, status);
+
+    CHECK_EQUAL(std::string("2"), cache.get_if_exists("opener").value_or("<missing>"));
+    CHECK_THROW(cache_type::open(name), std::system_error);
+  }
+
+  TEST(recovers_from_dead_lock_owner) {
+    libhoard::shm_cache<std::string, std::string, libhoard::snapshot_codec<std::string>, dying_codec> cache(16, 64);
+    cache.emplace("foo", "bar");
+
+    // The child dies while holding the lock.
+    run_child(
+        [&cache]() {
+          dying_codec::die = true;
+          cache.get_if_exists("foo");
+          return 1;
+        });
+
+    // The cache was cleared, since the child may have left it inconsistent.
+    CHECK_EQUAL(0u, cache.size());
+    cache.emplace("foo", "baz");
+    CHECK_EQUAL(std::string("baz"), cache.get_if_exists("foo").value_or("<missing>"));
+  }
+}
@@ -0,0 +1,116 @@
+#include <libhoard/snapshot_policy.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "UnitTest++/UnitTest++.h"
+
+#include <libhoard/cache.h>
+#include <libhoard/mmap_snapshot.h>
+#include <libhoard/resolver_policy.h>
+
+SUITE(snapshot_policy) {
+  class fixture {
+    public:
+    using snapshot_type = libhoard::mmap_snapshot<std::string, std::string>;
+
+    struct resolver_impl {
+      explicit resolver_impl(fixture& self) noexcept
+      : self(&self)
+      {}
+
+      auto operator()(const std::string& key) const -> std::tuple<std::string> {
+        ++self->resolver_called_count;
+        return std::make_tuple("resolved " + key);
+      }
+
+      private:
+      fixture* self;
+    };
+
+    fixture() {
+      const std::vector<std::pair<std::string, std::string>> values{
+        { "one", "een" },
+        { "two", "twee" },
+        { "three", "drie" },
+      };
+      snapshot_type::write(path, values.begin(), values.end());
+    }
+
+    ~fixture() {
+      std::remove(path.c_str());
+    }
+
+    const std::string path = (std::filesystem::temp_directory_path() / "libhoard_snapshot_policy_test.snapshot").string();
+    int resolver_called_count = 0;
+  };
+
+  TEST_FIXTURE(fixture, snapshot_lookup) {
+    const snapshot_type snapshot(path);
+
+    CHECK_EQUAL(3u, snapshot.size());
+    CHECK_EQUAL(std::string("een"), snapshot.lookup(std::string("one")).value());
+    CHECK_EQUAL(std::string("drie"), snapshot.lookup(std::string_view("three")).value());
+    CHECK(snapshot.lookup_view("two") == std::string_view("twee"));
+    CHECK(!snapshot.lookup(std::string("four")).has_value());
+  }
+
+  TEST(snapshot_lookup_trivial_types) {
+    const std::string path = (std::filesystem::temp_directory_path() / "libhoard_snapshot_policy_test_int.snapshot").string();
+    std::vector<std::pair<int, double>> values;
+    for (int i = 0; i < 1000; ++i) values.emplace_back(i, i * 0.5);
+    libhoard::mmap_snapshot<int, double>::write(path, values.begin(), values.end());
+
+    const libhoard::mmap_snapshot<int, double> snapshot(path);
+    std::remove(path.c_str());
+
+    CHECK_EQUAL(1000u, snapshot.size());
+    for (int i = 0; i < 1000; ++i) CHECK_EQUAL(i * 0.5, snapshot.lookup(i).value());
+    CHECK(!snapshot.lookup(1000).has_value());
+    CHECK(!snapshot.lookup(-1).has_value());
+  }
+
+  TEST_FIXTURE(fixture, cache_consults_snapshot_on_miss) {
+    libhoard::cache<std::string, std::string, libhoard::snapshot_policy<snapshot_type>> cache(
+        libhoard::snapshot_policy<snapshot_type>(std::make_shared<const snapshot_type>(path)));
+
+    CHECK_EQUAL(std::string("een"), cache.get("one").value());
+    CHECK(!cache.get("four").has_value());
+
+    // Cache values take precedence over the snapshot.
+    cache.emplace("one", "uno");
+    CHECK_EQUAL(std::string("uno"), cache.get("one").value());
+  }
+
+  TEST_FIXTURE(fixture, snapshot_is_consulted_before_resolver) {
+    using cache_type = libhoard::cache<std::string, std::string, libhoard::snapshot_policy<snapshot_type>, libhoard::resolver_policy<resolver_impl>>;
+    cache_type cache(
+        libhoard::snapshot_policy<snapshot_type>(std::make_shared<const snapshot_type>(path)),
+        libhoard::resolver_policy<resolver_impl>(resolver_impl(*this)));
+
+    CHECK_EQUAL(std::string("twee"), cache.get(std::string("two")));
+    CHECK_EQUAL(0, resolver_called_count);
+
+    CHECK_EQUAL(std::string("resolved four"), cache.get(std::string("four")));
+    CHECK_EQUAL(1, resolver_called_count);
+  }
+
+  TEST(open_invalid_file) {
+    const std::string path = (std::filesystem::temp_directory_path() / "libhoard_snapshot_policy_test_invalid.snapshot").string();
+    {
+      std::FILE* f = std::fopen(path.c_str(), "wb");
+      std::fputs("this is definitely not a snapshot file, it's just some text", f);
+      std::fclose(f);
+    }
+
+    using snapshot_type = libhoard::mmap_snapshot<int, int>;
+    CHECK_THROW(snapshot_type{ path }, std::runtime_error);
+    std::remove(path.c_str());
+  }
+}
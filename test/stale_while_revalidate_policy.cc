@@ -0,0 +1,131 @@
+#include <libhoard/stale_while_revalidate_policy.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+
+#include "UnitTest++/UnitTest++.h"
+
+#include <libhoard/cache.h>
+#include <libhoard/resolver_policy.h>
+
+SUITE(stale_while_revalidate_policy) {
+  using clock = std::chrono::steady_clock;
+  using namespace std::literals::chrono_literals;
+
+  class fixture {
+    public:
+    struct resolver_impl {
+      explicit resolver_impl(fixture* self) : self(self) {}
+
+      auto operator()(int key) const -> std::tuple<std::string> {
+        return std::make_tuple(std::to_string(key) + "/" + std::to_string(++self->calls));
+      }
+
+      fixture* self;
+    };
+
+    using cache_type = libhoard::cache<int, std::string,
+          libhoard::resolver_policy<resolver_impl>,
+          libhoard::stale_while_revalidate_policy<clock>>;
+
+    auto make_cache(clock::duration max_age, clock::duration grace) -> cache_type {
+      return cache_type(
+          libhoard::resolver_policy<resolver_impl>(resolver_impl(this)),
+          libhoard::stale_while_revalidate_policy<clock>(max_age, grace));
+    }
+
+    std::atomic<int> calls{ 0 };
+  };
+
+  TEST_FIXTURE(fixture, fresh_value) {
+    cache_type cache = make_cache(1h, 1h);
+
+    CHECK_EQUAL("3/1", cache.get(3));
+    const auto [value, stale] = cache.get_with_staleness(3);
+    CHECK_EQUAL("3/1", value);
+    CHECK(!stale);
+    CHECK_EQUAL(1, calls.load());
+  }
+
+  TEST_FIXTURE(fixture, stale_value_is_served_and_reloaded) {
+    cache_type cache = make_cache(20ms, 1h);
+
+    CHECK_EQUAL("3/1", cache.get(3));
+    std::this_thread::sleep_for(50ms);
+
+    // The stale value is returned, and a reload is started.
+    const auto [value, stale] = cache.get_with_staleness(3);
+    CHECK_EQUAL("3/1", value);
+    CHECK(stale);
+
+    const auto deadline = clock::now() + 10s;
+    while (cache.get_if_exists(3) != std::optional<std::string>("3/2") && clock::now() < deadline)
+      std::this_thread::sleep_for(1ms);
+    CHECK_EQUAL("3/2", cache.get_if_exists(3).value_or("nothing"));
+    CHECK(!cache.get_with_staleness(3).second);
+  }
+
+  TEST_FIXTURE(fixture, missing_value_is_resolved_fresh) {
+    cache_type cache = make_cache(1h, 1h);
+
+    const auto [value, stale] = cache.get_with_staleness(4);
+    CHECK_EQUAL("4/1", value);
+    CHECK(!stale);
+  }
+
+  TEST_FIXTURE(fixture, unread_stale_values_are_not_reloaded) {
+    cache_type cache = make_cache(20ms, 1h);
+
+    CHECK_EQUAL("3/1", cache.get(3));
+    std::this_thread::sleep_for(50ms);
+    CHECK_EQUAL("3/1", cache.get_if_exists(3).value_or("nothing")); // Doesn't count as a read.
+    std::this_thread::sleep_for(10ms);
+    CHECK_EQUAL(1, calls.load());
+  }
+
+  TEST_FIXTURE(fixture, value_expires_after_grace) {
+    cache_type cache = make_cache(10ms, 10ms);
+
+    CHECK_EQUAL("3/1", cache.get(3));
+    std::this_thread::sleep_for(50ms);
+    CHECK(!cache.get_if_exists(3).has_value());
+    CHECK_EQUAL("3/2", cache.get(3)); // Resolved on the spot.
+  }
+
+  TEST(throwing_reload_is_dropped) {
+    std::atomic<int> calls{ 0 };
+
+    // The first reload throws, everything else resolves.
+    auto resolver = [&calls](const auto& callback_ptr, int key) {
+      const int n = ++calls;
+      if (n == 2) throw std::runtime_error("reload failed");
+      callback_ptr->assign(std::to_string(key) + "/" + std::to_string(n));
+    };
+    libhoard::cache<int, std::string,
+        libhoard::async_resolver_policy<decltype(resolver)>,
+        libhoard::stale_while_revalidate_policy<clock>> cache{
+            libhoard::async_resolver_policy<decltype(resolver)>(resolver),
+            libhoard::stale_while_revalidate_policy<clock>(20ms, 1h)};
+    auto get = [&cache](int key) { return std::get<0>(cache.get(key).get()); };
+
+    CHECK_EQUAL("3/1", get(3));
+    std::this_thread::sleep_for(50ms);
+    CHECK_EQUAL("3/1", get(3)); // Starts the reload that throws.
+
+    const auto deadline = clock::now() + 10s;
+    while (calls < 2 && clock::now() < deadline) std::this_thread::sleep_for(1ms);
+    REQUIRE CHECK(calls >= 2);
+
+    // The worker survived, and performs the next reload.
+    CHECK_EQUAL("4/3", get(4));
+    std::this_thread::sleep_for(50ms);
+    CHECK_EQUAL("4/3", get(4));
+    while (cache.get_if_exists(4) != std::optional<std::string>("4/4") && clock::now() < deadline)
+      std::this_thread::sleep_for(1ms);
+    CHECK_EQUAL("4/4", cache.get_if_exists(4).value_or("nothing"));
+  }
+}
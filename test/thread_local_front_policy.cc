@@ -0,0 +1,206 @@
+#include <libhoard/thread_local_front_policy.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "UnitTest++/UnitTest++.h"
+#include "test_clock.h"
+
+#include <libhoard/cache.h>
+#include <libhoard/max_age_policy.h>
+#include <libhoard/refresh_policy.h>
+#include <libhoard/resolver_policy.h>
+#include <libhoard/thread_safe_policy.h>
+
+using namespace std::literals::chrono_literals;
+
+SUITE(thread_local_front_policy) {
+  ///\brief Mutex that counts how often it is locked.
+  class counting_mutex {
+    public:
+    auto lock() -> void {
+      mtx_.lock();
+      ++locks;
+    }
+
+    auto try_lock() -> bool {
+      if (!mtx_.try_lock()) return false;
+      ++locks;
+      return true;
+    }
+
+    auto unlock() -> void {
+      mtx_.unlock();
+    }
+
+    static inline int locks = 0;
+
+    private:
+    std::mutex mtx_;
+  };
+
+  using cache_type = libhoard::cache<int, std::string,
+        libhoard::basic_thread_safe_policy<counting_mutex>,
+        libhoard::thread_local_front_policy>;
+
+  TEST(hit_skips_lock) {
+    cache_type cache = cache_type(libhoard::thread_local_front_policy(4));
+    cache.emplace(1, "one");
+
+    CHECK_EQUAL(std::string("one"), cache.get(1).value_or(""));
+    const int locks = counting_mutex::locks;
+    CHECK_EQUAL(std::string("one"), cache.get(1).value_or(""));
+    CHECK_EQUAL(std::string("one"), *cache.get_handle(1));
+    CHECK_EQUAL(locks, counting_mutex::locks);
+  }
+
+  TEST(emplace_invalidates) {
+    cache_type cache = cache_type(libhoard::thread_local_front_policy(4));
+    cache.emplace(1, "one");
+    CHECK_EQUAL(std::string("one"), cache.get(1).value_or(""));
+
+    cache.emplace(1, "uno");
+    CHECK_EQUAL(std::string("uno"), cache.get(1).value_or(""));
+  }
+
+  TEST(erase_invalidates) {
+    cache_type cache = cache_type(libhoard::thread_local_front_policy(4));
+    cache.emplace(1, "one");
+    cache.emplace(2, "two");
+    CHECK_EQUAL(std::string("one"), cache.get(1).value_or(""));
+    CHECK_EQUAL(std::string("two"), cache.get(2).value_or(""));
+
+    cache.erase(1);
+    CHECK(!cache.get(1).has_value());
+    CHECK_EQUAL(std::string("two"), cache.get(2).value_or(""));
+
+    cache.clear();
+    CHECK(!cache.get(2).has_value());
+  }
+
+  TEST(colliding_keys) {
+    cache_type cache = cache_type(libhoard::thread_local_front_policy(1));
+    cache.emplace(1, "one");
+    cache.emplace(2, "two");
+
+    for (int i = 0; i < 2; ++i) {
+      CHECK_EQUAL(std::string("one"), cache.get(1).value_or(""));
+      CHECK_EQUAL(std::string("two"), cache.get(2).value_or(""));
+    }
+  }
+
+  TEST(fronts_are_per_thread) {
+    cache_type cache = cache_type(libhoard::thread_local_front_policy(4));
+    cache.emplace(1, "one");
+    std::thread([&cache]() { cache.get(1); }).join();
+
+    const int locks = counting_mutex::locks;
+    CHECK_EQUAL(std::string("one"), cache.get(1).value_or(""));
+    CHECK_EQUAL(locks + 1, counting_mutex::locks);
+  }
+
+  TEST(expired_values_are_not_served) {
+    using expiring_cache_type = libhoard::cache<int, std::string,
+          libhoard::max_age_policy<test_clock>,
+          libhoard::thread_local_front_policy>;
+    expiring_cache_type cache = expiring_cache_type(libhoard::max_age_policy<test_clock>(10s), libhoard::thread_local_front_policy(4));
+
+    test_clock::set_time(0s);
+    cache.emplace(1, "one");
+    CHECK_EQUAL(std::string("one"), cache.get(1).value_or(""));
+    CHECK_EQUAL(std::string("one"), cache.get(1).value_or(""));
+
+    test_clock::set_time(10s);
+    CHECK(!cache.get(1).has_value());
+  }
+
+  TEST(concurrent_readers_and_writer) {
+    using plain_cache_type = libhoard::cache<int, int, libhoard::thread_local_front_policy>;
+    plain_cache_type cache = plain_cache_type(libhoard::thread_local_front_policy(4));
+    cache.emplace(1, 0);
+
+    std::atomic<bool> failed{ false };
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t) {
+      readers.emplace_back(
+          [&cache, &failed]() {
+            int last = 0;
+            for (int i = 0; i < 2000; ++i) {
+              const int v = cache.get(1).value_or(-1);
+              // The writer only increases the value.
+              if (v < last) failed = true;
+              last = v;
+            }
+          });
+    }
+    for (int i = 1; i <= 200; ++i) cache.emplace(1, i);
+    for (auto& thr : readers) thr.join();
+
+    CHECK(!failed);
+    CHECK_EQUAL(200, cache.get(1).value_or(-1));
+  }
+
+  struct identity_resolver {
+    auto operator()(int n) const -> std::tuple<int> {
+      return std::make_tuple(n);
+    }
+  };
+
+  TEST(front_read_races_locked_hit) {
+    // The idle timer makes every locked hit update the expiry of the element,
+    // while the front cache checks that expiry without the lock.
+    using refresh_cache_type = libhoard::cache<int, int,
+          libhoard::thread_safe_policy,
+          libhoard::resolver_policy<identity_resolver>,
+          libhoard::refresh_policy<std::chrono::steady_clock>,
+          libhoard::thread_local_front_policy>;
+    refresh_cache_type cache = refresh_cache_type(
+        libhoard::resolver_policy<identity_resolver>(),
+        libhoard::refresh_policy<std::chrono::steady_clock>(1h, 1h),
+        libhoard::thread_local_front_policy(4));
+
+    std::atomic<bool> done{ false };
+    std::atomic<bool> failed{ false };
+    std::thread front_reader(
+        [&cache, &done, &failed]() {
+          while (!done) {
+            if (cache.get(1) != 1) failed = true;
+          }
+        });
+    // Each new thread has an empty front cache, so its lookup takes the lock.
+    for (int i = 0; i < 100; ++i) {
+      std::thread([&cache, &failed]() {
+            if (cache.get(1) != 1) failed = true;
+          }).join();
+    }
+    done = true;
+    front_reader.join();
+
+    CHECK(!failed);
+  }
+
+  struct resolver {
+    auto operator()(int n) const -> std::tuple<std::string::size_type, char> {
+      ++calls;
+      return std::make_tuple(std::string::size_type(n), 'x');
+    }
+
+    static inline int calls = 0;
+  };
+
+  TEST(resolver) {
+    using resolver_cache_type = libhoard::cache<int, std::string,
+          libhoard::resolver_policy<resolver>,
+          libhoard::thread_local_front_policy>;
+    resolver_cache_type cache = resolver_cache_type(libhoard::resolver_policy<resolver>(), libhoard::thread_local_front_policy(4));
+
+    for (int i = 0; i < 3; ++i) CHECK_EQUAL(std::string("xxx"), cache.get(3));
+    CHECK_EQUAL(std::string("xxx"), *cache.get_handle(3));
+    CHECK_EQUAL(1, resolver::calls);
+  }
+}
@@ -0,0 +1,99 @@
+#include <libhoard/thread_safe_policy.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "UnitTest++/UnitTest++.h"
+
+#include <libhoard/cache.h>
+#include <libhoard/mutex.h>
+#include <libhoard/refresh_ahead_policy.h>
+#include <libhoard/resolver_policy.h>
+
+SUITE(thread_safe_policy) {
+  struct immediate_resolver {
+    template<typename CallbackPtr>
+    auto operator()(const CallbackPtr& callback_ptr, int n) const -> void {
+      callback_ptr->assign(n, 'x');
+    }
+  };
+
+  struct dropping_resolver {
+    template<typename CallbackPtr>
+    auto operator()([[maybe_unused]] const CallbackPtr& callback_ptr, [[maybe_unused]] int n) const -> void {}
+  };
+
+  TEST(explicit_mutex_satisfies_dependency) {
+    using helper = libhoard::detail::hashtable_helper_<int, std::string,
+          libhoard::basic_thread_safe_policy<std::mutex>,
+          libhoard::refresh_ahead_policy<std::chrono::steady_clock>>;
+
+    CHECK(helper::all_policies::has_type_v<libhoard::basic_thread_safe_policy<std::mutex>>);
+    CHECK(!helper::all_policies::has_type_v<libhoard::thread_safe_policy>);
+  }
+
+  TEST(non_recursive_mutex_with_immediate_async_resolver) {
+    using cache_type = libhoard::cache<int, std::string,
+          libhoard::basic_thread_safe_policy<std::mutex>,
+          libhoard::async_resolver_policy<immediate_resolver>>;
+    cache_type cache = cache_type(libhoard::async_resolver_policy<immediate_resolver>(immediate_resolver()));
+
+    auto three = cache.get(3).get();
+    CHECK_EQUAL(0u, three.index());
+    CHECK_EQUAL(std::string("xxx"), std::get<0>(three));
+  }
+
+  TEST(non_recursive_mutex_with_dropped_callback) {
+    using cache_type = libhoard::cache<int, std::string,
+          libhoard::basic_thread_safe_policy<std::mutex>,
+          libhoard::async_resolver_policy<dropping_resolver>>;
+    cache_type cache = cache_type(libhoard::async_resolver_policy<dropping_resolver>(dropping_resolver()));
+
+    // The callback is cancelled during the lookup. This must not deadlock.
+    auto future = cache.get(3);
+    CHECK(future.valid());
+  }
+
+  TEST(recursive_lock_keeps_ownership_until_outermost_unlock) {
+    using policy_type = libhoard::basic_thread_safe_policy<std::recursive_mutex>;
+    policy_type::table_base<void, void, void> impl{policy_type(), std::allocator<int>()};
+
+    impl.lock();
+    impl.lock();
+    impl.unlock();
+    CHECK(impl.owns_lock_());
+    impl.unlock();
+    CHECK(!impl.owns_lock_());
+
+    CHECK(impl.try_lock());
+    impl.lock();
+    impl.unlock();
+    CHECK(impl.owns_lock_());
+    impl.unlock();
+    CHECK(!impl.owns_lock_());
+  }
+
+  TEST(adaptive_mutex_cache) {
+    using cache_type = libhoard::cache<int, int, libhoard::basic_thread_safe_policy<libhoard::adaptive_mutex>>;
+    cache_type cache;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back(
+          [&cache, t]() {
+            for (int i = 0; i < 1000; ++i) {
+              cache.emplace(t * 1000 + i, i);
+              cache.get(t * 1000 + i);
+            }
+          });
+    }
+    for (auto& thr : threads) thr.join();
+
+    CHECK_EQUAL(999, cache.get(3999).value_or(-1));
+  }
+}
@@ -0,0 +1,216 @@
+#include <libhoard/tiered_policy.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "UnitTest++/UnitTest++.h"
+
+#include <libhoard/cache.h>
+#include <libhoard/file_store.h>
+#include <libhoard/max_size_policy.h>
+#include <libhoard/resolver_policy.h>
+#include <libhoard/sharded_cache.h>
+#include <libhoard/thread_safe_policy.h>
+
+SUITE(tiered_policy) {
+  // Policy that makes linking new elements fail, while the flag is set.
+  class failing_link_policy {
+    public:
+    template<typename HashTable, typename ValueType, typename Allocator>
+    class table_base {
+      public:
+      table_base(const failing_link_policy& policy, [[maybe_unused]] const Allocator& alloc) noexcept
+      : fail(policy.fail)
+      {}
+
+      auto on_reserve_([[maybe_unused]] ValueType* vptr) -> void {
+        if (*fail) throw std::runtime_error("link failed");
+      }
+
+      private:
+      std::shared_ptr<bool> fail;
+    };
+
+    explicit failing_link_policy(std::shared_ptr<bool> fail) noexcept
+    : fail(std::move(fail))
+    {}
+
+    private:
+    std::shared_ptr<bool> fail;
+  };
+
+  class fixture {
+    public:
+    using store_type = libhoard::file_store<int, std::string>;
+
+    struct resolver_impl {
+      explicit resolver_impl(fixture& self) noexcept
+      : self(&self)
+      {}
+
+      auto operator()(int key) const -> std::tuple<std::string> {
+        ++self->resolver_called_count;
+        return std::make_tuple("value " + std::to_string(key));
+      }
+
+      private:
+      fixture* self;
+    };
+
+    using cache_type = libhoard::cache<int, std::string,
+          libhoard::max_size_policy,
+          libhoard::tiered_policy<store_type>,
+          libhoard::resolver_policy<resolver_impl>>;
+
+    auto make_cache(std::size_t max_size) -> cache_type {
+      return cache_type(
+          libhoard::max_size_policy(max_size),
+          libhoard::tiered_policy<store_type>(store),
+          libhoard::resolver_policy<resolver_impl>(resolver_impl(*this)));
+    }
+
+    const std::string path = (std::filesystem::temp_directory_path() / "libhoard_tiered_policy_test.store").string();
+    const std::shared_ptr<store_type> store = std::make_shared<store_type>(path, 0);
+    int resolver_called_count = 0;
+  };
+
+  TEST(file_store) {
+    const std::string path = (std::filesystem::temp_directory_path() / "libhoard_tiered_policy_test_file_store.store").string();
+    libhoard::file_store<int, std::string> store(path, 0);
+    CHECK(!std::filesystem::exists(path)); // The file is unlinked immediately.
+
+    for (int i = 0; i < 100; ++i) store.put(std::size_t(i % 7), i, "value " + std::to_string(i));
+    CHECK_EQUAL(100u, store.size());
+
+    CHECK_EQUAL(std::string("value 42"), store.take(42 % 7, [](int k) { return k == 42; }).value());
+    CHECK(!store.take(42 % 7, [](int k) { return k == 42; }).has_value());
+    CHECK_EQUAL(99u, store.size());
+
+    // Remove most values, which triggers compaction on the next put.
+    for (int i = 0; i < 90; ++i) store.erase(std::size_t(i % 7), [i](int k) { return k == i; });
+    const auto file_size_before_compaction = store.file_size();
+    store.put(0, 1000, "value 1000");
+    CHECK(store.file_size() < file_size_before_compaction);
+
+    // Surviving values are intact.
+    for (int i = 90; i < 100; ++i)
+      CHECK_EQUAL("value " + std::to_string(i), store.take(std::size_t(i % 7), [i](int k) { return k == i; }).value());
+    CHECK_EQUAL(std::string("value 1000"), store.take(0, [](int k) { return k == 1000; }).value());
+    CHECK(store.empty());
+  }
+
+  TEST_FIXTURE(fixture, evicted_values_are_demoted) {
+    auto cache = make_cache(5);
+    for (int i = 0; i < 20; ++i) cache.emplace(i, "demoted " + std::to_string(i));
+    CHECK(store->size() >= 15u);
+
+    // All values are still reachable, without invoking the resolver.
+    for (int i = 0; i < 20; ++i)
+      CHECK_EQUAL("demoted " + std::to_string(i), cache.get(i));
+    CHECK_EQUAL(0, resolver_called_count);
+  }
+
+  TEST_FIXTURE(fixture, promoted_values_leave_the_store) {
+    auto cache = make_cache(5);
+    for (int i = 0; i < 20; ++i) cache.emplace(i, "demoted " + std::to_string(i));
+    const auto store_size = store->size();
+
+    CHECK_EQUAL(std::string("demoted 0"), cache.get(0));
+    CHECK(store->size() <= store_size); // Promotion removes 0, but may demote another value.
+    CHECK_EQUAL(std::string("demoted 0"), cache.get_if_exists(0).value());
+  }
+
+  TEST_FIXTURE(fixture, handle_refers_to_promoted_value) {
+    auto cache = make_cache(5);
+    for (int i = 0; i < 20; ++i) cache.emplace(i, "demoted " + std::to_string(i));
+
+    // Find a key that was demoted.
+    std::vector<bool> cached(20, false);
+    cache.for_each([&cached](int key, [[maybe_unused]] const std::string& value) { cached[key] = true; });
+    const int key = static_cast<int>(std::find(cached.begin(), cached.end(), false) - cached.begin());
+    REQUIRE CHECK(key < 20);
+
+    // The first handle promotes the value, the second one finds it in the cache.
+    auto promoted = cache.get_handle(key);
+    auto found = cache.get_handle(key);
+    CHECK(promoted.get() == found.get());
+    CHECK_EQUAL("demoted " + std::to_string(key), *promoted);
+  }
+
+  TEST_FIXTURE(fixture, erase_removes_from_store) {
+    auto cache = make_cache(5);
+    for (int i = 0; i < 20; ++i) cache.emplace(i, "demoted " + std::to_string(i));
+
+    cache.erase(0);
+    CHECK_EQUAL(std::string("value 0"), cache.get(0));
+    CHECK_EQUAL(1, resolver_called_count);
+  }
+
+  TEST_FIXTURE(fixture, clear_empties_store) {
+    auto cache = make_cache(5);
+    for (int i = 0; i < 20; ++i) cache.emplace(i, "demoted " + std::to_string(i));
+
+    cache.clear();
+    CHECK(store->empty());
+    CHECK_EQUAL(std::string("value 0"), cache.get(0));
+    CHECK_EQUAL(1, resolver_called_count);
+  }
+
+  TEST_FIXTURE(fixture, failed_promotion_keeps_value_in_store) {
+    using failing_cache_type = libhoard::cache<int, std::string,
+          libhoard::tiered_policy<store_type>,
+          failing_link_policy>;
+
+    const auto fail = std::make_shared<bool>(true);
+    failing_cache_type cache = failing_cache_type(
+        libhoard::tiered_policy<store_type>(store),
+        failing_link_policy(fail));
+    store->put(0, 0, "stored");
+
+    CHECK_THROW(cache.get(0), std::runtime_error);
+    CHECK(!store->empty());
+
+    *fail = false;
+    CHECK_EQUAL(std::string("stored"), cache.get(0).value());
+    CHECK(store->empty());
+  }
+
+  TEST(shards_share_the_store) {
+    using store_type = libhoard::file_store<int, std::string>;
+    using cache_type = libhoard::sharded_cache<int, std::string,
+          libhoard::thread_safe_policy,
+          libhoard::max_size_policy,
+          libhoard::tiered_policy<store_type>>;
+
+    const std::string path = (std::filesystem::temp_directory_path() / "libhoard_tiered_policy_test_shards.store").string();
+    const auto store = std::make_shared<store_type>(path, 0);
+    cache_type cache(4, libhoard::max_size_policy(2), libhoard::tiered_policy<store_type>(store));
+
+    // Each thread demotes into, and promotes from, the single store, while holding the lock of a different shard.
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back(
+          [&cache, t]() {
+            for (int i = 0; i < 200; ++i) {
+              const int key = t * 1000 + i;
+              cache.emplace(key, "value " + std::to_string(key));
+              cache.get(t * 1000 + i / 2);
+            }
+          });
+    }
+    for (auto& thr : threads) thr.join();
+
+    for (int t = 0; t < 4; ++t) {
+      for (int i = 0; i < 200; ++i) {
+        const int key = t * 1000 + i;
+        CHECK_EQUAL("value " + std::to_string(key), cache.get(key).value());
+      }
+    }
+  }
+}